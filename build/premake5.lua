@@ -11,6 +11,17 @@ Projects = {
 		LibsRelease = {},
 		AdditionalDependencies = {}
 	},
+	{
+		Name = "ErewhonBench",
+		Kind = "ConsoleApp",
+		Defines = {},
+		Files = {"../include/Shared/Enums", "../include/Shared/Utils", "../include/Shared/Protocol/**", "../src/Shared/Enums", "../src/Shared/Utils", "../src/Shared/Protocol/**", "../src/Server/ArenaStatePacker", "../src/Server/SpatialGrid", "../src/Bench/**"},
+		Includes = {"../thirdparty/include"},
+		Libs = os.istarget("windows") and {} or {"pthread"},
+		LibsDebug = {"NazaraCore-d", "NazaraNetwork-d"},
+		LibsRelease = {"NazaraCore", "NazaraNetwork"},
+		AdditionalDependencies = {}
+	},
 	{
 		Name = "ErewhonClient",
 		Kind = "ConsoleApp",
@@ -32,6 +43,17 @@ Projects = {
 		LibsDebug = {"argon2-d", "NazaraCore-d", "NazaraLua-d", "NazaraNetwork-d", "NazaraNoise-d", "NazaraPhysics2D-d", "NazaraPhysics3D-d", "NazaraSDKServer-d", "NazaraUtility-d"},
 		LibsRelease = {"argon2", "NazaraCore", "NazaraLua", "NazaraNetwork", "NazaraNoise", "NazaraPhysics2D", "NazaraPhysics3D", "NazaraSDKServer", "NazaraUtility"},
 		AdditionalDependencies = {"libeay32", "libintl-8", "libiconv-2", "Newton", "ssleay32"}
+	},
+	{
+		Name = "ErewhonTests",
+		Kind = "ConsoleApp",
+		Defines = {},
+		Files = {"../include/Shared/Protocol/QuantizedTransform", "../src/Shared/Protocol/QuantizedTransform", "../src/Tests/**"},
+		Includes = {"../thirdparty/include"},
+		Libs = {},
+		LibsDebug = {"NazaraCore-d"},
+		LibsRelease = {"NazaraCore"},
+		AdditionalDependencies = {}
 	}
 }
 
@@ -41,7 +41,7 @@ namespace ewn
 			virtual void HandlePeerInfo(std::size_t peerId, const NetworkReactor::PeerInfo& peerInfo);
 			virtual void HandlePeerPacket(std::size_t peerId, Nz::NetPacket&& packet) = 0;
 
-			virtual void OnConfigLoaded(const ConfigFile& config);
+			virtual bool OnConfigLoaded(const ConfigFile& config);
 
 			std::atomic<Nz::UInt64> m_appTime;
 			Nz::Clock m_appClock;
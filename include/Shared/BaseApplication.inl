@@ -29,10 +29,7 @@ namespace ewn
 	inline bool BaseApplication::LoadConfig(const std::string& configFile)
 	{
 		if (m_config.LoadFromFile(configFile))
-		{
-			OnConfigLoaded(m_config);
-			return true;
-		}
+			return OnConfigLoaded(m_config);
 		else
 			return false;
 	}
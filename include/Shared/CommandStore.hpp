@@ -9,6 +9,7 @@
 
 #include <Nazara/Network/ENetPacket.hpp>
 #include <Nazara/Network/NetPacket.hpp>
+#include <Shared/SharedPacket.hpp>
 #include <Shared/Protocol/Packets.hpp>
 #include <functional>
 #include <type_traits>
@@ -33,6 +34,8 @@ namespace ewn
 
 			template<typename T>
 			void SerializePacket(Nz::NetPacket& packet, const T& data) const;
+			template<typename T>
+			SharedPacket SerializePacket(const T& data) const;
 
 			bool UnserializePacket(PeerRef peer, Nz::NetPacket&& packet) const;
 
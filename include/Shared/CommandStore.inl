@@ -100,6 +100,18 @@ namespace ewn
 		Packets::Serialize(serializer, dataRef);
 	}
 
+	template<typename Peer>
+	template<typename T>
+	SharedPacket CommandStore<Peer>::SerializePacket(const T& data) const
+	{
+		const OutgoingCommand& command = GetOutgoingCommand<T>();
+
+		Nz::NetPacket packet;
+		SerializePacket(packet, data);
+
+		return SharedPacket(command.channelId, command.flags, std::move(packet));
+	}
+
 	template<typename Peer>
 	bool CommandStore<Peer>::UnserializePacket(PeerRef peer, Nz::NetPacket&& packet) const
 	{
@@ -45,6 +45,16 @@ namespace ewn
 		ServerError
 	};
 
+	enum class EntityStateField : Nz::UInt8
+	{
+		AngularVelocity,
+		LinearVelocity,
+		Position,
+		Rotation,
+
+		Max = Rotation
+	};
+
 	enum class LoginFailureReason : Nz::UInt8
 	{
 		AccountNotFound,
@@ -99,6 +109,12 @@ namespace ewn
 
 namespace Nz
 {
+	template<>
+	struct EnumAsFlags<ewn::EntityStateField>
+	{
+		static constexpr ewn::EntityStateField max = ewn::EntityStateField::Max;
+	};
+
 	template<>
 	struct EnumAsFlags<ewn::SpaceshipQueryInfo>
 	{
@@ -108,6 +124,7 @@ namespace Nz
 
 namespace ewn
 {
+	using EntityStateFieldFlags = Nz::Flags<EntityStateField>;
 	using SpaceshipQueryInfoFlags = Nz::Flags<SpaceshipQueryInfo>;
 }
 
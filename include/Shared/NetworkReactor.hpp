@@ -9,9 +9,12 @@
 
 #include <Nazara/Core/Thread.hpp>
 #include <Nazara/Network/ENetHost.hpp>
+#include <Shared/SharedPacket.hpp>
+#include <Shared/Utils/LatencyHistogram.hpp>
 #include <concurrentqueue/concurrentqueue.h>
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <variant>
 #include <vector>
 
@@ -29,7 +32,7 @@ namespace ewn
 		public:
 			struct PeerInfo;
 
-			NetworkReactor(std::size_t firstId, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient);
+			NetworkReactor(std::size_t firstId, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient, std::size_t coreAffinity = NoCoreAffinity);
 			NetworkReactor(const NetworkReactor&) = delete;
 			NetworkReactor(NetworkReactor&&) = delete;
 			~NetworkReactor();
@@ -41,10 +44,13 @@ namespace ewn
 			void Poll(ConnectCB&& onConnection, DisconnectCB&& onDisconnection, DataCB&& onData, InfoCB&& onInfo);
 
 			inline Nz::NetProtocol GetProtocol() const;
+			inline LatencyHistogram& GetSendLatency();
+			inline const LatencyHistogram& GetSendLatency() const;
 
 			void QueryInfo(std::size_t peerId);
 
 			void SendData(std::size_t peerId, Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet);
+			void SendData(std::size_t peerId, SharedPacket packet);
 
 			NetworkReactor& operator=(const NetworkReactor&) = delete;
 			NetworkReactor& operator=(NetworkReactor&&) = delete;
@@ -53,14 +59,21 @@ namespace ewn
 			{
 				Nz::UInt32 lastReceiveTime;
 				Nz::UInt32 ping;
+				Nz::UInt32 totalPacketLost;
+				Nz::UInt32 totalPacketSent;
 			};
 
 			static constexpr std::size_t InvalidPeerId = std::numeric_limits<std::size_t>::max();
+			static constexpr std::size_t NoCoreAffinity = std::numeric_limits<std::size_t>::max();
 	
 		private:
-			void HandleConnectionRequests(const moodycamel::ConsumerToken& token);
+			void EnqueueIncomingPacket(std::size_t peerId, Nz::NetPacket&& packet, const moodycamel::ProducerToken& producterToken);
+			void FlushPendingBatch(std::size_t peerId);
+			void HandleConnectionRequests(moodycamel::ConsumerToken& token);
+			void QueueOutgoingPacket(std::size_t peerId, Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet);
+			void QueueOutgoingSharedPacket(std::size_t peerId, SharedPacket packet);
 			void ReceivePackets(const moodycamel::ProducerToken& producterToken);
-			void SendPackets(const moodycamel::ProducerToken& producterToken, const moodycamel::ConsumerToken& token);
+			void SendPackets(const moodycamel::ProducerToken& producterToken, moodycamel::ConsumerToken& token);
 			void WorkerThread();
 
 			struct ConnectionRequest
@@ -107,23 +120,51 @@ namespace ewn
 					Nz::ENetPacketFlags flags;
 					Nz::UInt8 channelId;
 					Nz::NetPacket packet;
+					Nz::UInt64 enqueueTime;
 				};
 
 				struct QueryPeerInfo {};
 
+				struct SharedPacketEvent
+				{
+					SharedPacket packet;
+					Nz::UInt64 enqueueTime;
+				};
+
 				std::size_t peerId = InvalidPeerId;
-				std::variant<DisconnectEvent, PacketEvent, QueryPeerInfo> data;
+				std::variant<DisconnectEvent, PacketEvent, QueryPeerInfo, SharedPacketEvent> data;
 			};
 
+			struct PendingBatch
+			{
+				std::size_t batchSize;
+				std::size_t packetCount = 0;
+				Nz::NetPacket batch;
+				Nz::NetPacket firstPacket;
+				Nz::UInt8 channelId;
+			};
+
+			static constexpr Nz::UInt8 BatchOpcode = 0xFF; //< Never used by a packet type
+			static constexpr std::size_t OutgoingBulkSize = 128;
+
 			std::atomic_bool m_running;
+			std::size_t m_coreAffinity;
 			std::size_t m_firstId;
 			std::vector<Nz::ENetPeer*> m_clients;
+			std::vector<Nz::UInt8> m_batchBuffer;
+			std::vector<Nz::UInt64> m_sentPacketTimes;
+			std::vector<OutgoingEvent> m_outgoingEvents;
+			std::vector<PendingBatch> m_pendingBatches;
+			std::vector<std::size_t> m_batchingPeers;
 			moodycamel::ConcurrentQueue<ConnectionRequest> m_connectionRequests;
 			moodycamel::ConcurrentQueue<IncomingEvent> m_incomingQueue;
 			moodycamel::ConcurrentQueue<OutgoingEvent> m_outgoingQueue;
 			Nz::ENetHost m_host;
+			Nz::ENetPacketRef m_cachedENetPacket;
 			Nz::NetProtocol m_protocol;
+			SharedPacket m_cachedSharedPacket;
 			Nz::Thread m_thread;
+			LatencyHistogram m_sendLatency;
 	};
 }
 
@@ -42,4 +42,14 @@ namespace ewn
 	{
 		return m_protocol;
 	}
+
+	inline LatencyHistogram& NetworkReactor::GetSendLatency()
+	{
+		return m_sendLatency;
+	}
+
+	inline const LatencyHistogram& NetworkReactor::GetSendLatency() const
+	{
+		return m_sendLatency;
+	}
 }
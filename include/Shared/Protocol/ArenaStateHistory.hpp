@@ -0,0 +1,45 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Shared" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SHARED_NETWORK_ARENASTATEHISTORY_HPP
+#define EREWHON_SHARED_NETWORK_ARENASTATEHISTORY_HPP
+
+#include <Shared/Protocol/Packets.hpp>
+#include <array>
+#include <bitset>
+
+namespace ewn
+{
+	// Keeps the last complete arena states, used as baselines for delta-compressed states
+	class ArenaStateHistory
+	{
+		public:
+			static constexpr std::size_t MaxStateCount = 32;
+
+			ArenaStateHistory() = default;
+			~ArenaStateHistory() = default;
+
+			inline void Clear();
+
+			bool DecodeState(Packets::ArenaState& state) const;
+
+			const Packets::ArenaState* GetState(Nz::UInt16 stateId) const;
+
+			void PushState(const Packets::ArenaState& state);
+
+			static EntityStateFieldFlags ComputeChangedFields(const Packets::ArenaState::Entity& baseline, const Packets::ArenaState::Entity& entity);
+			static std::size_t ComputeEntitySize(EntityStateFieldFlags fields);
+			static void EncodeDelta(const Packets::ArenaState& baseline, const Packets::ArenaState& state, Packets::ArenaState& delta);
+
+		private:
+			std::array<Packets::ArenaState, MaxStateCount> m_states;
+			std::bitset<MaxStateCount> m_validStates;
+	};
+}
+
+#include <Shared/Protocol/ArenaStateHistory.inl>
+
+#endif // EREWHON_SHARED_NETWORK_ARENASTATEHISTORY_HPP
@@ -0,0 +1,13 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Shared" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Shared/Protocol/ArenaStateHistory.hpp>
+
+namespace ewn
+{
+	inline void ArenaStateHistory::Clear()
+	{
+		m_validStates.reset();
+	}
+}
@@ -26,6 +26,8 @@ namespace ewn
 
 			void FillStore(Nz::UInt32 firstId, std::vector<std::string> strings);
 
+			inline std::optional<Nz::UInt32> FindStringIndex(const std::string& string) const;
+
 			inline const std::string& GetString(Nz::UInt32 id) const;
 			inline Nz::UInt32 GetStringIndex(const std::string& string) const;
 
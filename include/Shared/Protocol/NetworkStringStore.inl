@@ -18,6 +18,15 @@ namespace ewn
 		m_strings.clear();
 	}
 
+	inline std::optional<Nz::UInt32> NetworkStringStore::FindStringIndex(const std::string& string) const
+	{
+		auto it = m_stringMap.find(string);
+		if (it == m_stringMap.end())
+			return std::nullopt;
+
+		return it->second;
+	}
+
 	inline const std::string& NetworkStringStore::GetString(Nz::UInt32 id) const
 	{
 		assert(id < m_strings.size());
@@ -10,6 +10,7 @@
 #include <Shared/Enums.hpp>
 #include <Shared/Protocol/CompressedInteger.hpp>
 #include <Shared/Protocol/PacketSerializer.hpp>
+#include <Shared/Protocol/QuantizedTransform.hpp>
 #include <Nazara/Prerequisites.hpp>
 #include <Nazara/Core/String.hpp>
 #include <Nazara/Math/Box.hpp>
@@ -29,17 +30,17 @@ namespace ewn
 		ArenaPrefabs,
 		ArenaSounds,
 		ArenaState,
+		ArenaStateAck,
 		BotMessage,
 		ChatMessage,
+		ConnectionRedirect,
 		ControlEntity,
-		CreateEntities,
 		CreateFleet,
 		CreateFleetFailure,
 		CreateFleetSuccess,
 		CreateSpaceship,
 		CreateSpaceshipFailure,
 		CreateSpaceshipSuccess,
-		DeleteEntities,
 		DeleteFleet,
 		DeleteFleetFailure,
 		DeleteFleetSuccess,
@@ -171,9 +172,35 @@ namespace ewn
 
 		DeclarePacket(ArenaState)
 		{
+			// Network precision of entity states (positions are expected to stay in a 32km cube centered on the arena, ie. within 16km on each axis)
+			using AngularVelocityType = QuantizedVector3<32, 16>;
+			using LinearVelocityType = QuantizedVector3<1024, 16>;
+			using PositionType = QuantizedVector3<16384, 21>;
+			using RotationType = QuantizedQuaternion;
+
+			// Generation is incremented every time an entity id is created for a player, so repeated records can be recognized
+			struct CreatedEntity
+			{
+				CompressedUnsigned<Nz::UInt32> id;
+				CompressedUnsigned<Nz::UInt32> prefabId;
+				Nz::UInt8 generation;
+				Nz::Quaternionf rotation;
+				Nz::Vector3f angularVelocity;
+				Nz::Vector3f linearVelocity;
+				Nz::Vector3f position;
+				Nz::String visualName; //< only sent when not empty
+			};
+
+			struct DeletedEntity
+			{
+				CompressedUnsigned<Nz::UInt32> id;
+				Nz::UInt8 generation;
+			};
+
 			struct Entity
 			{
 				CompressedUnsigned<Nz::UInt32> id;
+				EntityStateFieldFlags fields; //< Fields not sent are the same as in the baseline
 				Nz::Vector3f angularVelocity;
 				Nz::Vector3f linearVelocity;
 				Nz::Vector3f position;
@@ -181,9 +208,17 @@ namespace ewn
 			};
 
 			Nz::UInt16 stateId;
+			Nz::UInt8 baselineOffset; //< stateId - baseline stateId, zero if there's no baseline
 			CompressedUnsigned<Nz::UInt64> serverTime;
 			CompressedUnsigned<Nz::UInt64> lastProcessedInputTime;
-			std::vector<Entity> entities;
+			std::vector<DeletedEntity> deletedEntities; //< Lifecycle records are repeated in the first state of every update until one of them is acknowledged
+			std::vector<CreatedEntity> createdEntities; //< applied after deletions
+			std::vector<Entity> entities; //< sorted by id
+		};
+
+		DeclarePacket(ArenaStateAck)
+		{
+			Nz::UInt16 stateId;
 		};
 
 		DeclarePacket(BotMessage)
@@ -197,25 +232,15 @@ namespace ewn
 			std::string message;
 		};
 
-		DeclarePacket(ControlEntity)
+		DeclarePacket(ConnectionRedirect)
 		{
-			CompressedUnsigned<Nz::UInt32> id;
+			Nz::UInt16 port;
+			Nz::UInt32 token;
 		};
 
-		DeclarePacket(CreateEntities)
+		DeclarePacket(ControlEntity)
 		{
-			struct Entity
-			{
-				CompressedUnsigned<Nz::UInt32> entityId;
-				CompressedUnsigned<Nz::UInt32> prefabId;
-				Nz::Quaternionf rotation;
-				Nz::Vector3f angularVelocity;
-				Nz::Vector3f linearVelocity;
-				Nz::Vector3f position;
-				Nz::String visualName;
-			};
-
-			std::vector<Entity> entities;
+			CompressedUnsigned<Nz::UInt32> id;
 		};
 
 		DeclarePacket(CreateFleet)
@@ -263,13 +288,6 @@ namespace ewn
 		{
 		};
 
-		DeclarePacket(DeleteEntities)
-		{
-			using EntityId = CompressedUnsigned<Nz::UInt32>;
-
-			std::vector<EntityId> entities;
-		};
-
 		DeclarePacket(DeleteFleet)
 		{
 			std::string fleetName;
@@ -588,17 +606,17 @@ namespace ewn
 		void Serialize(PacketSerializer& serializer, ArenaParticleSystems& data);
 		void Serialize(PacketSerializer& serializer, ArenaSounds& data);
 		void Serialize(PacketSerializer& serializer, ArenaState& data);
+		void Serialize(PacketSerializer& serializer, ArenaStateAck& data);
 		void Serialize(PacketSerializer& serializer, BotMessage& data);
 		void Serialize(PacketSerializer& serializer, ChatMessage& data);
+		void Serialize(PacketSerializer& serializer, ConnectionRedirect& data);
 		void Serialize(PacketSerializer& serializer, ControlEntity& data);
-		void Serialize(PacketSerializer& serializer, CreateEntities& data);
 		void Serialize(PacketSerializer& serializer, CreateFleet& data);
 		void Serialize(PacketSerializer& serializer, CreateFleetFailure& data);
 		void Serialize(PacketSerializer& serializer, CreateFleetSuccess& data);
 		void Serialize(PacketSerializer& serializer, CreateSpaceship& data);
 		void Serialize(PacketSerializer& serializer, CreateSpaceshipFailure& data);
 		void Serialize(PacketSerializer& serializer, CreateSpaceshipSuccess& data);
-		void Serialize(PacketSerializer& serializer, DeleteEntities& data);
 		void Serialize(PacketSerializer& serializer, DeleteFleet& data);
 		void Serialize(PacketSerializer& serializer, DeleteFleetFailure& data);
 		void Serialize(PacketSerializer& serializer, DeleteFleetSuccess& data);
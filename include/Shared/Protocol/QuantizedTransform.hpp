@@ -0,0 +1,69 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Shared" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SHARED_NETWORK_QUANTIZEDTRANSFORM_HPP
+#define EREWHON_SHARED_NETWORK_QUANTIZEDTRANSFORM_HPP
+
+#include <Nazara/Prerequisites.hpp>
+#include <Nazara/Core/Algorithm.hpp>
+#include <Nazara/Math/Quaternion.hpp>
+#include <Nazara/Math/Vector3.hpp>
+
+namespace ewn
+{
+	// Smallest-three encoding: index of the largest component on two bits and the three others on ten bits each
+	class QuantizedQuaternion
+	{
+		public:
+			explicit QuantizedQuaternion(const Nz::Quaternionf& quaternion = Nz::Quaternionf::Identity());
+			~QuantizedQuaternion() = default;
+
+			inline Nz::UInt32 GetBits() const;
+
+			inline void SetBits(Nz::UInt32 bits);
+
+			operator Nz::Quaternionf() const;
+
+			static constexpr std::size_t ByteCount = sizeof(Nz::UInt32);
+
+		private:
+			Nz::UInt32 m_bits;
+	};
+
+	// Fixed-point vector, each component is clamped to [-MaxValue, MaxValue] and stored on BitCount bits
+	template<unsigned int MaxValue, unsigned int BitCount>
+	class QuantizedVector3
+	{
+		static_assert(BitCount > 0 && BitCount <= 21);
+
+		public:
+			explicit QuantizedVector3(const Nz::Vector3f& vec = Nz::Vector3f::Zero());
+			~QuantizedVector3() = default;
+
+			Nz::UInt64 GetBits() const;
+
+			void SetBits(Nz::UInt64 bits);
+
+			operator Nz::Vector3f() const;
+
+			static constexpr std::size_t ByteCount = (3 * BitCount + 7) / 8;
+
+		private:
+			Nz::UInt64 m_bits;
+	};
+}
+
+namespace Nz
+{
+	inline bool Serialize(SerializationContext& context, ewn::QuantizedQuaternion value, TypeTag<ewn::QuantizedQuaternion>);
+	template<unsigned int MaxValue, unsigned int BitCount> bool Serialize(SerializationContext& context, ewn::QuantizedVector3<MaxValue, BitCount> value, TypeTag<ewn::QuantizedVector3<MaxValue, BitCount>>);
+	inline bool Unserialize(SerializationContext& context, ewn::QuantizedQuaternion* value, TypeTag<ewn::QuantizedQuaternion>);
+	template<unsigned int MaxValue, unsigned int BitCount> bool Unserialize(SerializationContext& context, ewn::QuantizedVector3<MaxValue, BitCount>* value, TypeTag<ewn::QuantizedVector3<MaxValue, BitCount>>);
+}
+
+#include <Shared/Protocol/QuantizedTransform.inl>
+
+#endif // EREWHON_SHARED_NETWORK_QUANTIZEDTRANSFORM_HPP
@@ -0,0 +1,116 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Shared" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Shared/Protocol/QuantizedTransform.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace ewn
+{
+	inline Nz::UInt32 QuantizedQuaternion::GetBits() const
+	{
+		return m_bits;
+	}
+
+	inline void QuantizedQuaternion::SetBits(Nz::UInt32 bits)
+	{
+		m_bits = bits;
+	}
+
+
+	template<unsigned int MaxValue, unsigned int BitCount>
+	QuantizedVector3<MaxValue, BitCount>::QuantizedVector3(const Nz::Vector3f& vec)
+	{
+		// Use an even number of steps so zero is exactly represented
+		constexpr Nz::UInt64 MaxInteger = (Nz::UInt64(1) << BitCount) - 2;
+		constexpr float Scale = MaxInteger / (2.f * MaxValue);
+
+		m_bits = 0;
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			float value = std::clamp(vec[i], -float(MaxValue), float(MaxValue));
+			Nz::UInt64 integerValue = std::min(static_cast<Nz::UInt64>(std::lround((value + MaxValue) * Scale)), MaxInteger);
+
+			m_bits |= integerValue << (i * BitCount);
+		}
+	}
+
+	template<unsigned int MaxValue, unsigned int BitCount>
+	Nz::UInt64 QuantizedVector3<MaxValue, BitCount>::GetBits() const
+	{
+		return m_bits;
+	}
+
+	template<unsigned int MaxValue, unsigned int BitCount>
+	void QuantizedVector3<MaxValue, BitCount>::SetBits(Nz::UInt64 bits)
+	{
+		m_bits = bits;
+	}
+
+	template<unsigned int MaxValue, unsigned int BitCount>
+	QuantizedVector3<MaxValue, BitCount>::operator Nz::Vector3f() const
+	{
+		constexpr Nz::UInt64 BitMask = (Nz::UInt64(1) << BitCount) - 1;
+		constexpr Nz::UInt64 MaxInteger = BitMask - 1;
+		constexpr float InvScale = (2.f * MaxValue) / MaxInteger;
+
+		Nz::Vector3f vec;
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			Nz::UInt64 integerValue = std::min((m_bits >> (i * BitCount)) & BitMask, MaxInteger);
+			vec[i] = integerValue * InvScale - MaxValue;
+		}
+
+		return vec;
+	}
+}
+
+namespace Nz
+{
+	inline bool Serialize(SerializationContext& context, ewn::QuantizedQuaternion value, TypeTag<ewn::QuantizedQuaternion>)
+	{
+		return Serialize(context, value.GetBits());
+	}
+
+	template<unsigned int MaxValue, unsigned int BitCount>
+	bool Serialize(SerializationContext& context, ewn::QuantizedVector3<MaxValue, BitCount> value, TypeTag<ewn::QuantizedVector3<MaxValue, BitCount>>)
+	{
+		// Only write the bytes we need
+		Nz::UInt64 bits = value.GetBits();
+		for (std::size_t i = 0; i < ewn::QuantizedVector3<MaxValue, BitCount>::ByteCount; ++i)
+		{
+			if (!Serialize(context, static_cast<Nz::UInt8>(bits >> (i * 8))))
+				return false;
+		}
+
+		return true;
+	}
+
+	inline bool Unserialize(SerializationContext& context, ewn::QuantizedQuaternion* value, TypeTag<ewn::QuantizedQuaternion>)
+	{
+		Nz::UInt32 bits;
+		if (!Unserialize(context, &bits))
+			return false;
+
+		value->SetBits(bits);
+		return true;
+	}
+
+	template<unsigned int MaxValue, unsigned int BitCount>
+	bool Unserialize(SerializationContext& context, ewn::QuantizedVector3<MaxValue, BitCount>* value, TypeTag<ewn::QuantizedVector3<MaxValue, BitCount>>)
+	{
+		Nz::UInt64 bits = 0;
+		for (std::size_t i = 0; i < ewn::QuantizedVector3<MaxValue, BitCount>::ByteCount; ++i)
+		{
+			Nz::UInt8 byteValue;
+			if (!Unserialize(context, &byteValue))
+				return false;
+
+			bits |= Nz::UInt64(byteValue) << (i * 8);
+		}
+
+		value->SetBits(bits);
+		return true;
+	}
+}
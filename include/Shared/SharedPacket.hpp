@@ -0,0 +1,47 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Shared" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SHARED_SHAREDPACKET_HPP
+#define EREWHON_SHARED_SHAREDPACKET_HPP
+
+#include <Nazara/Network/ENetPacket.hpp>
+#include <Nazara/Network/NetPacket.hpp>
+#include <memory>
+
+namespace ewn
+{
+	// Serialized packet which can be sent to any number of peers, its content cannot be modified once built
+	class SharedPacket
+	{
+		public:
+			SharedPacket() = default;
+			inline SharedPacket(Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet);
+			SharedPacket(const SharedPacket&) = default;
+			SharedPacket(SharedPacket&&) noexcept = default;
+			~SharedPacket() = default;
+
+			inline Nz::UInt8 GetChannel() const;
+			inline Nz::ENetPacketFlags GetFlags() const;
+			inline const Nz::NetPacket& GetPacket() const;
+
+			inline bool IsValid() const;
+
+			SharedPacket& operator=(const SharedPacket&) = default;
+			SharedPacket& operator=(SharedPacket&&) noexcept = default;
+
+			inline bool operator==(const SharedPacket& packet) const;
+			inline bool operator!=(const SharedPacket& packet) const;
+
+		private:
+			std::shared_ptr<const Nz::NetPacket> m_packet;
+			Nz::ENetPacketFlags m_flags;
+			Nz::UInt8 m_channelId = 0;
+	};
+}
+
+#include <Shared/SharedPacket.inl>
+
+#endif // EREWHON_SHARED_SHAREDPACKET_HPP
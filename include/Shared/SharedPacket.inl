@@ -0,0 +1,49 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Shared" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Shared/SharedPacket.hpp>
+#include <cassert>
+
+namespace ewn
+{
+	inline SharedPacket::SharedPacket(Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet) :
+	m_packet(std::make_shared<Nz::NetPacket>(std::move(packet))),
+	m_flags(flags),
+	m_channelId(channelId)
+	{
+	}
+
+	inline Nz::UInt8 SharedPacket::GetChannel() const
+	{
+		assert(IsValid());
+		return m_channelId;
+	}
+
+	inline Nz::ENetPacketFlags SharedPacket::GetFlags() const
+	{
+		assert(IsValid());
+		return m_flags;
+	}
+
+	inline const Nz::NetPacket& SharedPacket::GetPacket() const
+	{
+		assert(IsValid());
+		return *m_packet;
+	}
+
+	inline bool SharedPacket::IsValid() const
+	{
+		return m_packet != nullptr;
+	}
+
+	inline bool SharedPacket::operator==(const SharedPacket& packet) const
+	{
+		return m_packet == packet.m_packet && m_channelId == packet.m_channelId && m_flags == packet.m_flags;
+	}
+
+	inline bool SharedPacket::operator!=(const SharedPacket& packet) const
+	{
+		return !operator==(packet);
+	}
+}
@@ -40,6 +40,8 @@ namespace ewn
 	template<typename... Args> constexpr OverloadResolver<Args...> Overload = {};
 
 	Nz::Vector3f DampenedString(const Nz::Vector3f& currentPos, const Nz::Vector3f& targetPos, float frametime, float springStrength = 3.f);
+
+	std::size_t JumpConsistentHash(Nz::UInt64 key, std::size_t bucketCount);
 }
 
 #endif // EREWHON_SHARED_UTILS_HPP
@@ -0,0 +1,48 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Shared" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SHARED_UTILS_LATENCYHISTOGRAM_HPP
+#define EREWHON_SHARED_UTILS_LATENCYHISTOGRAM_HPP
+
+#include <Nazara/Prerequisites.hpp>
+#include <array>
+#include <atomic>
+
+namespace ewn
+{
+	// Power-of-two microsecond buckets, can be filled by one thread while another one reads it
+	class LatencyHistogram
+	{
+		public:
+			static constexpr std::size_t BucketCount = 24;
+
+			inline LatencyHistogram();
+			LatencyHistogram(const LatencyHistogram&) = delete;
+			LatencyHistogram(LatencyHistogram&&) = delete;
+			~LatencyHistogram() = default;
+
+			inline Nz::UInt64 GetBucketUpperBound(std::size_t bucketIndex) const;
+			inline Nz::UInt64 GetBucketValue(std::size_t bucketIndex) const;
+			inline Nz::UInt64 GetMaximum() const;
+			inline Nz::UInt64 GetPercentile(float percentile) const;
+			inline Nz::UInt64 GetSampleCount() const;
+
+			inline void Record(Nz::UInt64 latency);
+
+			inline void Reset();
+
+			LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+			LatencyHistogram& operator=(LatencyHistogram&&) = delete;
+
+		private:
+			std::array<std::atomic<Nz::UInt64>, BucketCount> m_buckets;
+			std::atomic<Nz::UInt64> m_maximum;
+	};
+}
+
+#include <Shared/Utils/LatencyHistogram.inl>
+
+#endif // EREWHON_SHARED_UTILS_LATENCYHISTOGRAM_HPP
@@ -0,0 +1,81 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Shared" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Shared/Utils/LatencyHistogram.hpp>
+#include <Nazara/Math/Algorithm.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace ewn
+{
+	inline LatencyHistogram::LatencyHistogram()
+	{
+		Reset();
+	}
+
+	inline Nz::UInt64 LatencyHistogram::GetBucketUpperBound(std::size_t bucketIndex) const
+	{
+		assert(bucketIndex < BucketCount);
+
+		// Bucket #0 holds zero latencies, bucket #i holds [2^(i-1), 2^i[ and the last one everything above
+		return Nz::UInt64(1) << bucketIndex;
+	}
+
+	inline Nz::UInt64 LatencyHistogram::GetBucketValue(std::size_t bucketIndex) const
+	{
+		assert(bucketIndex < BucketCount);
+
+		return m_buckets[bucketIndex].load(std::memory_order_relaxed);
+	}
+
+	inline Nz::UInt64 LatencyHistogram::GetMaximum() const
+	{
+		return m_maximum.load(std::memory_order_relaxed);
+	}
+
+	inline Nz::UInt64 LatencyHistogram::GetPercentile(float percentile) const
+	{
+		Nz::UInt64 sampleCount = GetSampleCount();
+		if (sampleCount == 0)
+			return 0;
+
+		Nz::UInt64 threshold = std::max<Nz::UInt64>(Nz::UInt64(sampleCount * percentile), 1);
+
+		Nz::UInt64 accumulatedCount = 0;
+		for (std::size_t i = 0; i < BucketCount; ++i)
+		{
+			accumulatedCount += GetBucketValue(i);
+			if (accumulatedCount >= threshold)
+				return std::min(GetBucketUpperBound(i), GetMaximum());
+		}
+
+		return GetMaximum();
+	}
+
+	inline Nz::UInt64 LatencyHistogram::GetSampleCount() const
+	{
+		Nz::UInt64 sampleCount = 0;
+		for (std::size_t i = 0; i < BucketCount; ++i)
+			sampleCount += GetBucketValue(i);
+
+		return sampleCount;
+	}
+
+	inline void LatencyHistogram::Record(Nz::UInt64 latency)
+	{
+		std::size_t bucketIndex = (latency > 0) ? std::min<std::size_t>(Nz::IntegralLog2(latency) + 1, BucketCount - 1) : 0;
+		m_buckets[bucketIndex].fetch_add(1, std::memory_order_relaxed);
+
+		Nz::UInt64 maximum = m_maximum.load(std::memory_order_relaxed);
+		while (latency > maximum && !m_maximum.compare_exchange_weak(maximum, latency, std::memory_order_relaxed));
+	}
+
+	inline void LatencyHistogram::Reset()
+	{
+		for (auto& bucket : m_buckets)
+			bucket.store(0, std::memory_order_relaxed);
+
+		m_maximum.store(0, std::memory_order_relaxed);
+	}
+}
@@ -10,9 +10,20 @@ Database = {
 }
 
 Game = {
-	MaxClients  = 100,
-	Port        = 2050,
-	WorkerCount = 2
+	ArenaThreads          = true,
+	BroadphaseCellSize    = 500,
+	InterestRadius        = 2000,
+	MaxClients            = 100,
+	MaxCommunicationRange = 5000,
+	MaxStateBandwidth     = 256 * 1024,
+	MinStateBandwidth     = 8 * 1024,
+	PinReactorThreads     = false,
+	Port                  = 2050,
+	ReactorCount          = 2,
+	ScriptStatsInterval   = 60,
+	ScriptWorkerCount     = 2,
+	TickRate              = 60,
+	WorkerCount           = 2
 }
 
 DefaultSpaceship = {
@@ -0,0 +1,246 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Bench" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Nazara/Core/Clock.hpp>
+#include <Nazara/Core/Initializer.hpp>
+#include <Nazara/Math/EulerAngles.hpp>
+#include <Nazara/Network/NetPacket.hpp>
+#include <Nazara/Network/Network.hpp>
+#include <Shared/Protocol/ArenaStateHistory.hpp>
+#include <Shared/Protocol/PacketSerializer.hpp>
+#include <Shared/Protocol/Packets.hpp>
+#include <Server/ArenaStatePacker.hpp>
+#include <Server/SpatialGrid.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+// Broadcast cost against moving entity count: runs what BroadcastSystem does for every player on each update
+// (interest query, priority accumulation, then ArenaStatePacker selecting and packing entities, delta encoding and serialization)
+
+namespace
+{
+	constexpr float ArenaSize = 20'000.f;
+	constexpr float InterestRadius = 2'000.f;
+	constexpr float UpdateInterval = 1.f / 30.f; //< BroadcastSystem update rate
+	constexpr std::size_t PlayerCount = 16;
+	constexpr std::size_t UpdateCount = 100;
+	constexpr std::size_t WarmupUpdateCount = 10;
+	constexpr Nz::UInt16 EntityPriority = 10;
+
+	struct MovingEntity
+	{
+		Nz::Quaternionf rotation;
+		Nz::Vector3f angularVelocity;
+		Nz::Vector3f linearVelocity;
+		Nz::Vector3f position;
+	};
+
+	struct PlayerView
+	{
+		ewn::ArenaStateHistory stateHistory;
+		ewn::Packets::ArenaState deltaPacket;
+		ewn::Packets::ArenaState statePacket;
+		std::optional<Nz::UInt16> lastStateId; //< Acknowledged right away, so it's always the baseline
+		std::vector<Nz::UInt16> priorities; //< indexed by entity id
+		Nz::Vector3f interestCenter;
+		Nz::UInt16 nextStateId = 0;
+	};
+
+	struct BenchResult
+	{
+		double updateTime; //< in microseconds
+		std::size_t relevantEntityCount; //< per player
+		std::size_t sentBytes; //< per player
+		std::size_t sentEntityCount; //< per player
+	};
+
+	void MoveEntities(std::vector<MovingEntity>& entities, ewn::SpatialGrid& grid)
+	{
+		grid.Clear();
+
+		for (std::size_t entityId = 0; entityId < entities.size(); ++entityId)
+		{
+			MovingEntity& entity = entities[entityId];
+			entity.position += entity.linearVelocity * UpdateInterval;
+
+			// Bounce on arena borders
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				if (std::abs(entity.position[i]) > ArenaSize / 2.f)
+					entity.linearVelocity[i] = -entity.linearVelocity[i];
+			}
+
+			grid.Insert(entityId, entity.position);
+		}
+	}
+
+	std::size_t SendPlayerState(PlayerView& view, const std::vector<ewn::Packets::ArenaState::Entity>& entityStates, const ewn::SpatialGrid& grid, ewn::ArenaStatePacker& statePacker, std::size_t& sentEntityCount)
+	{
+		statePacker.Clear();
+		grid.ForEachInSphere(view.interestCenter, InterestRadius, [&](std::size_t entityId, const Nz::Vector3f& position)
+		{
+			float priorityFactor = 1.f + std::max(1.f - position.Distance(view.interestCenter) / InterestRadius, 0.f);
+
+			Nz::UInt16& priorityAccumulator = view.priorities[entityId];
+			priorityAccumulator = ewn::ArenaStatePacker::AccumulatePriority(priorityAccumulator, EntityPriority, priorityFactor);
+
+			statePacker.QueueEntity(entityStates[entityId], priorityAccumulator);
+		});
+
+		view.statePacket.baselineOffset = 0;
+		view.statePacket.lastProcessedInputTime = 0;
+		view.statePacket.serverTime = 0;
+
+		// Bandwidth isn't limited, only the state count and size are
+		float bandwidthCredit = std::numeric_limits<float>::infinity();
+		std::size_t sentBytes = 0;
+
+		auto getBaseline = [&]()
+		{
+			return (view.lastStateId) ? view.stateHistory.GetState(*view.lastStateId) : nullptr;
+		};
+
+		auto sendState = [&](ewn::Packets::ArenaState& statePacket)
+		{
+			statePacket.stateId = view.nextStateId++;
+			view.stateHistory.PushState(statePacket);
+
+			const ewn::Packets::ArenaState* baseline = getBaseline();
+			if (baseline)
+				ewn::ArenaStateHistory::EncodeDelta(*baseline, statePacket, view.deltaPacket);
+
+			Nz::NetPacket packet;
+			packet << static_cast<Nz::UInt8>(ewn::Packets::ArenaState::Type);
+
+			ewn::PacketSerializer serializer(packet, true);
+			ewn::Packets::Serialize(serializer, (baseline) ? view.deltaPacket : statePacket);
+
+			sentBytes += packet.GetDataSize();
+			sentEntityCount += statePacket.entities.size();
+
+			for (const ewn::Packets::ArenaState::Entity& entityData : statePacket.entities)
+				view.priorities[entityData.id] = 0;
+
+			view.lastStateId = statePacket.stateId;
+		};
+
+		statePacker.PackStates(view.statePacket, 0, bandwidthCredit, getBaseline, sendState);
+
+		return sentBytes;
+	}
+
+	BenchResult RunBench(std::size_t entityCount, std::mt19937& randomGenerator)
+	{
+		std::uniform_real_distribution<float> positionDis(-ArenaSize / 2.f, ArenaSize / 2.f);
+		std::uniform_real_distribution<float> velocityDis(-200.f, 200.f);
+		std::uniform_real_distribution<float> angleDis(-180.f, 180.f);
+
+		std::vector<MovingEntity> entities(entityCount);
+		for (MovingEntity& entity : entities)
+		{
+			entity.angularVelocity = Nz::Vector3f(velocityDis(randomGenerator), velocityDis(randomGenerator), velocityDis(randomGenerator)) / 100.f;
+			entity.linearVelocity = Nz::Vector3f(velocityDis(randomGenerator), velocityDis(randomGenerator), velocityDis(randomGenerator));
+			entity.position = Nz::Vector3f(positionDis(randomGenerator), positionDis(randomGenerator), positionDis(randomGenerator));
+			entity.rotation = Nz::EulerAnglesf(angleDis(randomGenerator), angleDis(randomGenerator), angleDis(randomGenerator)).ToQuaternion();
+		}
+
+		std::vector<PlayerView> views(PlayerCount);
+		for (PlayerView& view : views)
+		{
+			view.interestCenter = Nz::Vector3f(positionDis(randomGenerator), positionDis(randomGenerator), positionDis(randomGenerator)) / 4.f;
+			view.priorities.resize(entityCount, 0);
+		}
+
+		ewn::SpatialGrid grid(InterestRadius);
+		ewn::ArenaStatePacker statePacker;
+		std::vector<ewn::Packets::ArenaState::Entity> entityStates(entityCount);
+
+		BenchResult result = {};
+
+		Nz::UInt64 totalTime = 0;
+		for (std::size_t update = 0; update < WarmupUpdateCount + UpdateCount; ++update)
+		{
+			Nz::UInt64 updateStart = Nz::GetElapsedMicroseconds();
+
+			MoveEntities(entities, grid);
+			for (std::size_t entityId = 0; entityId < entityCount; ++entityId)
+			{
+				// Like BroadcastSystem, gather quantized entity states once per update
+				const MovingEntity& entity = entities[entityId];
+
+				ewn::Packets::ArenaState::Entity& entityState = entityStates[entityId];
+				entityState.id = static_cast<Nz::UInt32>(entityId);
+				entityState.fields = ewn::EntityStateFieldFlags::ValueMask;
+				entityState.angularVelocity = ewn::Packets::ArenaState::AngularVelocityType(entity.angularVelocity);
+				entityState.linearVelocity = ewn::Packets::ArenaState::LinearVelocityType(entity.linearVelocity);
+				entityState.position = ewn::Packets::ArenaState::PositionType(entity.position);
+				entityState.rotation = ewn::Packets::ArenaState::RotationType(entity.rotation);
+			}
+
+			std::size_t sentBytes = 0;
+			std::size_t sentEntityCount = 0;
+			for (PlayerView& view : views)
+				sentBytes += SendPlayerState(view, entityStates, grid, statePacker, sentEntityCount);
+
+			Nz::UInt64 updateTime = Nz::GetElapsedMicroseconds() - updateStart;
+			if (update < WarmupUpdateCount)
+				continue;
+
+			totalTime += updateTime;
+			result.sentBytes += sentBytes;
+			result.sentEntityCount += sentEntityCount;
+
+			for (PlayerView& view : views)
+			{
+				grid.ForEachInSphere(view.interestCenter, InterestRadius, [&](std::size_t /*entityId*/, const Nz::Vector3f& /*position*/)
+				{
+					result.relevantEntityCount++;
+				});
+			}
+		}
+
+		result.updateTime = double(totalTime) / UpdateCount;
+		result.relevantEntityCount /= UpdateCount * PlayerCount;
+		result.sentBytes /= UpdateCount * PlayerCount;
+		result.sentEntityCount /= UpdateCount * PlayerCount;
+
+		return result;
+	}
+}
+
+int main()
+{
+	Nz::Initializer<Nz::Network> nazara; //< Network packets memory is handled by the network module
+	if (!nazara)
+	{
+		std::cerr << "Failed to initialize Nazara" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::mt19937 randomGenerator(42);
+
+	std::cout << "Broadcast cost for " << PlayerCount << " players, averaged over " << UpdateCount << " updates" << std::endl;
+	std::cout << std::setw(10) << "entities" << std::setw(12) << "relevant" << std::setw(10) << "sent" << std::setw(10) << "bytes" << std::setw(14) << "update (us)" << std::setw(14) << "player (us)" << std::endl;
+
+	for (std::size_t entityCount : { 250, 1'000, 4'000, 16'000, 64'000 })
+	{
+		BenchResult result = RunBench(entityCount, randomGenerator);
+
+		std::cout << std::setw(10) << entityCount;
+		std::cout << std::setw(12) << result.relevantEntityCount;
+		std::cout << std::setw(10) << result.sentEntityCount;
+		std::cout << std::setw(10) << result.sentBytes;
+		std::cout << std::setw(14) << std::fixed << std::setprecision(1) << result.updateTime;
+		std::cout << std::setw(14) << std::fixed << std::setprecision(1) << result.updateTime / PlayerCount << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -22,12 +22,10 @@ namespace ewn
 		return BaseApplication::Run();
 	}
 
-	bool ClientApplication::ConnectNewServer(const Nz::String& serverHostname, Nz::UInt32 data, ServerConnection* connection, std::size_t* peerId, NetworkReactor** peerReactor)
+	bool ClientApplication::ConnectNewServer(const Nz::String& serverHostname, Nz::UInt16 port, Nz::UInt32 data, ServerConnection* connection, std::size_t* peerId, NetworkReactor** peerReactor)
 	{
 		constexpr std::size_t MaxPeerCount = 1;
 
-		Nz::UInt16 port = m_config.GetIntegerOption<Nz::UInt16>("Server.Port");
-
 		Nz::NetProtocol hostnameProtocol = (m_config.GetBoolOption("Options.ForceIPv4")) ? Nz::NetProtocol_IPv4 : Nz::NetProtocol_Any;
 
 		Nz::ResolveError resolveError = Nz::ResolveError_NoError;
@@ -82,8 +80,11 @@ namespace ewn
 
 	void ClientApplication::HandlePeerDisconnection(std::size_t peerId, Nz::UInt32 data)
 	{
-		m_servers[peerId]->NotifyDisconnected(data);
+		// Connection may reconnect right away (redirection) and reuse the same peer id
+		ServerConnection* server = m_servers[peerId];
 		m_servers[peerId] = nullptr;
+
+		server->NotifyDisconnected(data);
 	}
 
 	void ClientApplication::HandlePeerInfo(std::size_t peerId, const NetworkReactor::PeerInfo& peerInfo)
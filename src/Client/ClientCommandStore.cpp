@@ -23,13 +23,12 @@ namespace ewn
 		IncomingCommand(ArenaState);
 		IncomingCommand(BotMessage);
 		IncomingCommand(ChatMessage);
+		IncomingCommand(ConnectionRedirect);
 		IncomingCommand(ControlEntity);
-		IncomingCommand(CreateEntities);
 		IncomingCommand(CreateFleetFailure);
 		IncomingCommand(CreateFleetSuccess);
 		IncomingCommand(CreateSpaceshipFailure);
 		IncomingCommand(CreateSpaceshipSuccess);
-		IncomingCommand(DeleteEntities);
 		IncomingCommand(DeleteFleetFailure);
 		IncomingCommand(DeleteFleetSuccess);
 		IncomingCommand(DeleteSpaceshipFailure);
@@ -55,6 +54,7 @@ namespace ewn
 		IncomingCommand(UpdateSpaceshipSuccess);
 
 		// Outgoing commands
+		OutgoingCommand(ArenaStateAck,      0,                           1);
 		OutgoingCommand(ControlEntity,      Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(CreateFleet,        Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(CreateSpaceship,    Nz::ENetPacketFlag_Reliable, 0);
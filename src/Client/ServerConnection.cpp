@@ -13,7 +13,11 @@ namespace ewn
 			Disconnect(0);
 
 		m_connected = false;
-		return m_application.ConnectNewServer(serverHostname, data, this, &m_peerId, &m_networkReactor);
+		m_pendingRedirection.reset();
+		m_serverHostname = serverHostname;
+
+		Nz::UInt16 port = m_application.GetConfig().GetIntegerOption<Nz::UInt16>("Server.Port");
+		return m_application.ConnectNewServer(serverHostname, port, data, this, &m_peerId, &m_networkReactor);
 	}
 
 	Nz::UInt64 ServerConnection::EstimateServerTime() const
@@ -21,10 +25,44 @@ namespace ewn
 		return m_application.GetAppTime() + m_deltaTime;
 	}
 
+	void ServerConnection::NotifyDisconnected(Nz::UInt32 data)
+	{
+		m_connected = false;
+		m_peerId = NetworkReactor::InvalidPeerId;
+		m_stringStore.Clear();
+
+		if (m_pendingRedirection)
+		{
+			Packets::ConnectionRedirect redirection = std::move(*m_pendingRedirection);
+			m_pendingRedirection.reset();
+
+			// Server dropped us after telling us where to go, this is not a real disconnection
+			if (m_application.ConnectNewServer(m_serverHostname, redirection.port, redirection.token, this, &m_peerId, &m_networkReactor))
+				return;
+		}
+
+		OnDisconnected(this, data);
+	}
+
 	void ServerConnection::UpdateNetworkStrings(ServerConnection* server, const Packets::NetworkStrings& data)
 	{
 		assert(server == this);
 
 		m_stringStore.FillStore(data.startId, std::move(data.strings));
+
+		// First packet the server sends once it accepted our session
+		if (!m_connected)
+		{
+			m_connected = true;
+
+			OnConnected(this, m_connectionData);
+		}
+	}
+
+	void ServerConnection::UpdateRedirection(ServerConnection* server, const Packets::ConnectionRedirect& data)
+	{
+		assert(server == this);
+
+		m_pendingRedirection = data;
 	}
 }
@@ -12,6 +12,7 @@
 #include <Client/ClientCommandStore.hpp>
 #include <Nazara/Core/Signal.hpp>
 #include <Nazara/Core/String.hpp>
+#include <optional>
 
 namespace ewn
 {
@@ -65,13 +66,12 @@ namespace ewn
 			NazaraSignal(OnArenaState,                ServerConnection* /*server*/, const Packets::ArenaState&                /*data*/);
 			NazaraSignal(OnBotMessage,                ServerConnection* /*server*/, const Packets::BotMessage&                /*data*/);
 			NazaraSignal(OnChatMessage,               ServerConnection* /*server*/, const Packets::ChatMessage&               /*data*/);
+			NazaraSignal(OnConnectionRedirect,        ServerConnection* /*server*/, const Packets::ConnectionRedirect&        /*data*/);
 			NazaraSignal(OnControlEntity,             ServerConnection* /*server*/, const Packets::ControlEntity&             /*data*/);
-			NazaraSignal(OnCreateEntities,            ServerConnection* /*server*/, const Packets::CreateEntities&            /*data*/);
 			NazaraSignal(OnCreateFleetFailure,        ServerConnection* /*server*/, const Packets::CreateFleetFailure&        /*data*/);
 			NazaraSignal(OnCreateFleetSuccess,        ServerConnection* /*server*/, const Packets::CreateFleetSuccess&        /*data*/);
 			NazaraSignal(OnCreateSpaceshipFailure,    ServerConnection* /*server*/, const Packets::CreateSpaceshipFailure&    /*data*/);
 			NazaraSignal(OnCreateSpaceshipSuccess,    ServerConnection* /*server*/, const Packets::CreateSpaceshipSuccess&    /*data*/);
-			NazaraSignal(OnDeleteEntities,            ServerConnection* /*server*/, const Packets::DeleteEntities&            /*data*/);
 			NazaraSignal(OnDeleteFleetFailure,        ServerConnection* /*server*/, const Packets::DeleteFleetFailure&        /*data*/);
 			NazaraSignal(OnDeleteFleetSuccess,        ServerConnection* /*server*/, const Packets::DeleteFleetSuccess&        /*data*/);
 			NazaraSignal(OnDeleteSpaceshipFailure,    ServerConnection* /*server*/, const Packets::DeleteSpaceshipFailure&    /*data*/);
@@ -105,17 +105,21 @@ namespace ewn
 		private:
 			inline void DispatchIncomingPacket(Nz::NetPacket&& packet);
 			inline void NotifyConnected(Nz::UInt32 data);
-			inline void NotifyDisconnected(Nz::UInt32 data);
+			void NotifyDisconnected(Nz::UInt32 data);
 			inline void UpdateInfo(const ConnectionInfo& connectionInfo);
 
 			void UpdateNetworkStrings(ServerConnection* server, const Packets::NetworkStrings& data);
+			void UpdateRedirection(ServerConnection* server, const Packets::ConnectionRedirect& data);
 
 			ClientApplication& m_application;
 			ClientCommandStore m_commandStore;
 			NetworkStringStore m_stringStore;
 			NetworkReactor* m_networkReactor;
 			ConnectionInfo m_connectionInfo;
+			Nz::String m_serverHostname;
 			Nz::UInt64 m_deltaTime;
+			Nz::UInt32 m_connectionData;
+			std::optional<Packets::ConnectionRedirect> m_pendingRedirection;
 			std::size_t m_peerId;
 			bool m_connected;
 	};
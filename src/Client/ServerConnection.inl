@@ -13,9 +13,11 @@ namespace ewn
 	m_application(application),
 	m_commandStore(this),
 	m_networkReactor(nullptr),
+	m_connectionData(0),
 	m_peerId(NetworkReactor::InvalidPeerId),
 	m_connected(false)
 	{
+		OnConnectionRedirect.Connect([this](ServerConnection* server, const Packets::ConnectionRedirect& data) { UpdateRedirection(server, data); });
 		OnNetworkStrings.Connect([this](ServerConnection* server, const Packets::NetworkStrings& data) { UpdateNetworkStrings(server, data); });
 	}
 
@@ -88,18 +90,8 @@ namespace ewn
 
 	inline void ServerConnection::NotifyConnected(Nz::UInt32 data)
 	{
-		m_connected = true;
-
-		OnConnected(this, data);
-	}
-
-	inline void ServerConnection::NotifyDisconnected(Nz::UInt32 data)
-	{
-		m_connected = false;
-		m_peerId = NetworkReactor::InvalidPeerId;
-		m_stringStore.Clear();
-
-		OnDisconnected(this, data);
+		// Server may still redirect us to another of its reactors, we're only connected once it sent us its network strings
+		m_connectionData = data;
 	}
 
 	inline void ServerConnection::UpdateInfo(const ConnectionInfo& connectionInfo)
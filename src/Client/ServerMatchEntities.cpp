@@ -42,8 +42,6 @@ namespace ewn
 		m_onArenaPrefabsSlot.Connect(server->OnArenaPrefabs, this, &ServerMatchEntities::OnArenaPrefabs);
 		m_onArenaSoundsSlot.Connect(server->OnArenaSounds, this,   &ServerMatchEntities::OnArenaSounds);
 		m_onArenaStateSlot.Connect(server->OnArenaState, this,     &ServerMatchEntities::OnArenaState);
-		m_onCreateEntitySlot.Connect(server->OnCreateEntities, this, &ServerMatchEntities::OnCreateEntities);
-		m_onDeleteEntitySlot.Connect(server->OnDeleteEntities, this, &ServerMatchEntities::OnDeleteEntities);
 		m_onInstantiateParticleSystemSlot.Connect(server->OnInstantiateParticleSystem, this, &ServerMatchEntities::OnInstantiateParticleSystem);
 		m_onPlaySoundSlot.Connect(server->OnPlaySound, this,       &ServerMatchEntities::OnPlaySound);
 
@@ -84,10 +82,11 @@ namespace ewn
 		if (m_stateHandlingEnabled)
 		{
 			Nz::UInt64 serverTime = m_server->EstimateServerTime();
-			if (!m_jitterBuffer.empty() && serverTime >= m_jitterBuffer.front().applyTime)
+			// Server may send multiple partial states per tick, apply every one that is due
+			while (!m_jitterBuffer.empty() && serverTime >= m_jitterBuffer.front().applyTime)
 			{
 				ApplySnapshot(m_jitterBuffer.front());
-				m_jitterBuffer.pop_back();
+				m_jitterBuffer.pop_front();
 			}
 		}
 
@@ -167,6 +166,68 @@ namespace ewn
 		}*/
 	}
 
+	void ServerMatchEntities::CreateEntity(const Packets::ArenaState::CreatedEntity& entityData)
+	{
+		ServerEntity& data = CreateServerEntity(entityData.id);
+		data.generation = entityData.generation;
+
+		data.positionError = Nz::Vector3f::Zero();
+		data.rotationError = Nz::Quaternionf::Identity();
+
+		data.entity = m_prefabs[entityData.prefabId]->Clone();
+
+		data.name = entityData.visualName.ToStdString();
+
+		auto& entityNode = data.entity->GetComponent<Ndk::NodeComponent>();
+		entityNode.SetPosition(entityData.position);
+		entityNode.SetRotation(entityData.rotation);
+
+		auto& entityPhys = data.entity->GetComponent<Ndk::PhysicsComponent3D>();
+		entityPhys.SetAngularVelocity(entityData.angularVelocity);
+		entityPhys.SetLinearVelocity(entityData.linearVelocity);
+		entityPhys.SetPosition(entityData.position);
+		entityPhys.SetRotation(entityData.rotation);
+
+		if (data.entity->HasComponent<SoundEmitterComponent>())
+		{
+			auto& soundEmitter = data.entity->GetComponent<SoundEmitterComponent>();
+			soundEmitter.Play();
+		}
+
+		Nz::Color textColor = (entityData.visualName == "Lynix") ? Nz::Color::Cyan : Nz::Color::White;
+
+		// Create entity name entity
+		if (!entityData.visualName.IsEmpty())
+		{
+			Nz::TextSpriteRef textSprite = Nz::TextSprite::New();
+			textSprite->SetMaterial(Nz::MaterialLibrary::Get("SpaceshipText"));
+			textSprite->Update(Nz::SimpleTextDrawer::Draw(entityData.visualName, 96, 0U, textColor));
+			textSprite->SetScale(0.01f);
+
+			data.textEntity = m_world->CreateEntity();
+			data.textEntity->AddComponent<Ndk::GraphicsComponent>().Attach(textSprite);
+			data.textEntity->AddComponent<Ndk::NodeComponent>();
+		}
+
+		OnEntityCreated(this, data);
+	}
+
+	void ServerMatchEntities::DeleteEntity(Nz::UInt32 id)
+	{
+		ServerEntity& data = GetServerEntity(id);
+
+		if (data.debugGhostEntity)
+			data.debugGhostEntity->Kill();
+
+		if (data.textEntity)
+			data.textEntity->Kill();
+
+		data.entity->Kill();
+		data.isValid = false;
+
+		OnEntityDelete(this, data);
+	}
+
 	void ServerMatchEntities::FillVisualEffectFactory()
 	{
 		// Earth
@@ -703,94 +764,73 @@ namespace ewn
 		}
 	}
 
-	void ServerMatchEntities::OnArenaState(ServerConnection* server, const Packets::ArenaState& arenaState)
+	void ServerMatchEntities::OnArenaState(ServerConnection* server, const Packets::ArenaState& arenaStatePacket)
 	{
-		// For now, allocate a new snapshot, we will recycle them in a further iteration (to prevent memory allocation)
-		Snapshot snapshot;
-		snapshot.entities.resize(arenaState.entities.size());
-		for (std::size_t i = 0; i < snapshot.entities.size(); ++i)
-		{
-			Snapshot::Entity& entity = snapshot.entities[i];
-			const Packets::ArenaState::Entity& packetEntity = arenaState.entities[i];
+		// Rebuild the full state from the baseline it was compressed against
+		m_arenaState = arenaStatePacket;
+		if (!m_stateHistory.DecodeState(m_arenaState))
+			return; //< We don't know the baseline anymore, the server will fall back to full states
 
-			entity.id = packetEntity.id;
-			entity.angularVelocity = packetEntity.angularVelocity;
-			entity.linearVelocity = packetEntity.linearVelocity;
-			entity.position = packetEntity.position;
-			entity.rotation = packetEntity.rotation;
-		}
-
-		snapshot.applyTime = arenaState.serverTime + m_snapshotDelay;
-		snapshot.stateId = arenaState.stateId;
+		const Packets::ArenaState& arenaState = m_arenaState;
+		m_stateHistory.PushState(arenaState);
 
-		m_jitterBuffer.push_back(std::move(snapshot));
-	}
+		// States may arrive out of order, older ones carry outdated entity records (and states)
+		bool outdated = (m_lastStateId && static_cast<Nz::UInt16>(arenaState.stateId - *m_lastStateId) >= 0x8000);
 
-	void ServerMatchEntities::OnCreateEntities(ServerConnection*, const Packets::CreateEntities& createPacket)
-	{
-		for (const auto& entityData : createPacket.entities)
+		// Acknowledge it so the server can use it as a baseline, unless it carries entity records we won't apply (the server would consider them received)
+		if (!outdated || (arenaState.createdEntities.empty() && arenaState.deletedEntities.empty()))
 		{
-			ServerEntity& data = CreateServerEntity(entityData.entityId);
-
-			data.positionError = Nz::Vector3f::Zero();
-			data.rotationError = Nz::Quaternionf::Identity();
+			Packets::ArenaStateAck stateAck;
+			stateAck.stateId = arenaState.stateId;
 
-			data.entity = m_prefabs[entityData.prefabId]->Clone();
+			server->SendPacket(stateAck);
+		}
 
-			data.name = entityData.visualName.ToStdString();
+		if (outdated)
+			return;
 
-			auto& entityNode = data.entity->GetComponent<Ndk::NodeComponent>();
-			entityNode.SetPosition(entityData.position);
-			entityNode.SetRotation(entityData.rotation);
+		m_lastStateId = arenaState.stateId;
 
-			auto& entityPhys = data.entity->GetComponent<Ndk::PhysicsComponent3D>();
-			entityPhys.SetAngularVelocity(entityData.angularVelocity);
-			entityPhys.SetLinearVelocity(entityData.linearVelocity);
-			entityPhys.SetPosition(entityData.position);
-			entityPhys.SetRotation(entityData.rotation);
+		// Entity records are repeated until acknowledged, generations allow us to recognize the ones we already applied
+		for (const auto& entityData : arenaState.deletedEntities)
+		{
+			if (IsServerEntityValid(entityData.id) && GetServerEntity(entityData.id).generation == entityData.generation)
+				DeleteEntity(entityData.id);
+		}
 
-			if (data.entity->HasComponent<SoundEmitterComponent>())
+		for (const auto& entityData : arenaState.createdEntities)
+		{
+			if (IsServerEntityValid(entityData.id))
 			{
-				auto& soundEmitter = data.entity->GetComponent<SoundEmitterComponent>();
-				soundEmitter.Play();
-			}
-
-			Nz::Color textColor = (entityData.visualName == "Lynix") ? Nz::Color::Cyan : Nz::Color::White;
+				if (GetServerEntity(entityData.id).generation == entityData.generation)
+					continue;
 
-			// Create entity name entity
-			if (!entityData.visualName.IsEmpty())
-			{
-				Nz::TextSpriteRef textSprite = Nz::TextSprite::New();
-				textSprite->SetMaterial(Nz::MaterialLibrary::Get("SpaceshipText"));
-				textSprite->Update(Nz::SimpleTextDrawer::Draw(entityData.visualName, 96, 0U, textColor));
-				textSprite->SetScale(0.01f);
-
-				data.textEntity = m_world->CreateEntity();
-				data.textEntity->AddComponent<Ndk::GraphicsComponent>().Attach(textSprite);
-				data.textEntity->AddComponent<Ndk::NodeComponent>();
+				// We missed its deletion
+				DeleteEntity(entityData.id);
 			}
 
-			OnEntityCreated(this, data);
+			CreateEntity(entityData);
 		}
-	}
 
-	void ServerMatchEntities::OnDeleteEntities(ServerConnection*, const Packets::DeleteEntities& deletePacket)
-	{
-		for (std::size_t entityId : deletePacket.entities)
+		// For now, allocate a new snapshot, we will recycle them in a further iteration (to prevent memory allocation)
+		Snapshot snapshot;
+		snapshot.entities.resize(arenaState.entities.size());
+		for (std::size_t i = 0; i < snapshot.entities.size(); ++i)
 		{
-			ServerEntity& data = GetServerEntity(entityId);
-
-			if (data.debugGhostEntity)
-				data.debugGhostEntity->Kill();
+			Snapshot::Entity& entity = snapshot.entities[i];
+			const Packets::ArenaState::Entity& packetEntity = arenaState.entities[i];
 
-			if (data.textEntity)
-				data.textEntity->Kill();
+			entity.id = packetEntity.id;
+			entity.angularVelocity = packetEntity.angularVelocity;
+			entity.linearVelocity = packetEntity.linearVelocity;
+			entity.position = packetEntity.position;
+			entity.rotation = packetEntity.rotation;
+		}
 
-			data.entity->Kill();
-			data.isValid = false;
+		snapshot.applyTime = arenaState.serverTime + m_snapshotDelay;
+		snapshot.stateId = arenaState.stateId;
 
-			OnEntityDelete(this, data);
-		}
+		m_jitterBuffer.push_back(std::move(snapshot));
 	}
 
 	void ServerMatchEntities::OnInstantiateParticleSystem(ServerConnection* server, const Packets::InstantiateParticleSystem& instantiatePacket)
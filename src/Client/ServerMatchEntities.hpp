@@ -14,10 +14,12 @@
 #include <Nazara/Network/UdpSocket.hpp>
 #include <NDK/EntityOwner.hpp>
 #include <NDK/World.hpp>
+#include <Shared/Protocol/ArenaStateHistory.hpp>
 #include <Shared/Protocol/Packets.hpp>
 #include <Client/ServerConnection.hpp>
 #include <nonstd/ring_span.hpp>
 #include <array>
+#include <optional>
 #include <random>
 #include <vector>
 
@@ -54,6 +56,7 @@ namespace ewn
 				Nz::Quaternionf rotationError;
 				Nz::Vector3f positionError;
 				Nz::UInt32 serverId;
+				Nz::UInt8 generation = 0;
 				bool isValid = false;
 				std::string name; //< remove asap, used for temporary client-side radar
 			};
@@ -64,7 +67,9 @@ namespace ewn
 		private:
 			struct Snapshot;
 
+			void CreateEntity(const Packets::ArenaState::CreatedEntity& entityData);
 			inline ServerEntity& CreateServerEntity(Nz::UInt32 id);
+			void DeleteEntity(Nz::UInt32 id);
 			void FillVisualEffectFactory();
 			void HandlePlayingSounds();
 
@@ -72,8 +77,6 @@ namespace ewn
 			void OnArenaParticleSystems(ServerConnection* server, const Packets::ArenaParticleSystems& arenaParticleSystems);
 			void OnArenaSounds(ServerConnection* server, const Packets::ArenaSounds& arenaSounds);
 			void OnArenaState(ServerConnection* server, const Packets::ArenaState& arenaState);
-			void OnCreateEntities(ServerConnection* server, const Packets::CreateEntities& createPacket);
-			void OnDeleteEntities(ServerConnection* server, const Packets::DeleteEntities& deletePacket);
 			void OnInstantiateParticleSystem(ServerConnection* server, const Packets::InstantiateParticleSystem& instantiatePacket);
 			void OnPlaySound(ServerConnection* server, const Packets::PlaySound& playSound);
 
@@ -111,16 +114,17 @@ namespace ewn
 			NazaraSlot(ServerConnection, OnArenaPrefabs,              m_onArenaPrefabsSlot);
 			NazaraSlot(ServerConnection, OnArenaSounds,               m_onArenaSoundsSlot);
 			NazaraSlot(ServerConnection, OnArenaState,                m_onArenaStateSlot);
-			NazaraSlot(ServerConnection, OnCreateEntities,            m_onCreateEntitySlot);
-			NazaraSlot(ServerConnection, OnDeleteEntities,            m_onDeleteEntitySlot);
 			NazaraSlot(ServerConnection, OnInstantiateParticleSystem, m_onInstantiateParticleSystemSlot);
 			NazaraSlot(ServerConnection, OnPlaySound,                 m_onPlaySoundSlot);
 
 			using PrefabFactoryFunction = std::function<void(ClientApplication* app, const Ndk::EntityHandle& entity)>;
 
-			std::array<Snapshot, 5> m_jitterBufferData;
+			std::array<Snapshot, 20> m_jitterBufferData; //< Up to four states per server tick
 			nonstd::ring_span<Snapshot> m_jitterBuffer;
+			ArenaStateHistory m_stateHistory;
+			Packets::ArenaState m_arenaState;
 			std::mt19937 m_randomGenerator;
+			std::optional<Nz::UInt16> m_lastStateId;
 			std::unordered_map<std::string, PrefabFactoryFunction> m_visualEffectFactory;
 			std::vector<Ndk::EntityOwner> m_prefabs;
 			std::vector<Nz::Sound> m_playingSounds;
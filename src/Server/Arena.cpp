@@ -24,8 +24,10 @@
 #include <Server/Components/SynchronizedComponent.hpp>
 #include <Server/Scripting/ArenaInterface.hpp>
 #include <Server/Systems/BroadcastSystem.hpp>
+#include <Server/Systems/BroadphaseSystem.hpp>
 #include <Server/Systems/LifeTimeSystem.hpp>
 #include <Server/Systems/NavigationSystem.hpp>
+#include <Server/Systems/RadarSystem.hpp>
 #include <Server/Systems/ScriptSystem.hpp>
 #include <Server/Systems/InputSystem.hpp>
 #include <cassert>
@@ -38,12 +40,13 @@ namespace ewn
 	Arena::Arena(ServerApplication* app, std::string name, std::string scriptName) :
 	m_name(std::move(name)),
 	m_scriptName(std::move(scriptName)),
+	m_commandStore(app->GetCommandStore()),
 	m_app(app)
 	{
+		m_world.AddSystem<BroadphaseSystem>(m_app);
+
 		auto& broadcastSystem = m_world.AddSystem<BroadcastSystem>(m_app);
-		broadcastSystem.BroadcastEntitiesCreation.Connect(this,    &Arena::OnBroadcastEntitiesCreation);
-		broadcastSystem.BroadcastEntitiesDestruction.Connect(this, &Arena::OnBroadcastEntitiesDestruction);
-		broadcastSystem.BroadcastStateUpdate.Connect(this,       &Arena::OnBroadcastStateUpdate);
+		broadcastSystem.BroadcastStateUpdate.Connect(this, &Arena::OnBroadcastStateUpdate);
 
 		if (sendServerGhosts)
 			broadcastSystem.SetMaximumUpdateRate(60.f);
@@ -53,6 +56,7 @@ namespace ewn
 		m_world.AddSystem<InputSystem>();
 		m_world.AddSystem<LifeTimeSystem>();
 		m_world.AddSystem<NavigationSystem>(m_app);
+		m_world.AddSystem<RadarSystem>(m_app);
 		m_world.AddSystem<ScriptSystem>(m_app, this);
 
 		Nz::PhysWorld3D& world = m_world.GetSystem<Ndk::PhysicsSystem3D>().GetWorld();
@@ -80,6 +84,9 @@ namespace ewn
 			return HandleTorpedoProjectileCollision(firstBody, secondBody);
 		});
 
+		RegisterEntityArchetypes();
+
+		BuildArenaData();
 		LoadScript(m_scriptName);
 
 		Reset();
@@ -93,12 +100,22 @@ namespace ewn
 
 	Arena::~Arena()
 	{
+		// Pending commands may hold the last reference to a player, release them while the arena is still alive
+		Command command;
+		while (m_commandQueue.try_dequeue(command))
+			command = nullptr;
+
 		m_world.Clear();
 	}
 
+	std::vector<std::string> Arena::BuildScriptStatsReport(std::size_t maxOwnerCount)
+	{
+		return m_world.GetSystem<ScriptSystem>().BuildStatsReport(maxOwnerCount);
+	}
+
 	const Ndk::EntityHandle& Arena::CreatePlasmaProjectile(Player* owner, const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
 	{
-		const Ndk::EntityHandle& projectile = CreateEntity("plasmabeam", {}, owner, position, rotation);
+		const Ndk::EntityHandle& projectile = CreateEntity(m_plasmaBeamArchetypeId, {}, owner, position, rotation);
 		projectile->GetComponent<ProjectileComponent>().MarkAsHit(emitter);
 
 		auto& projectilePhys = projectile->GetComponent<Ndk::PhysicsComponent3D>();
@@ -109,7 +126,7 @@ namespace ewn
 
 	const Ndk::EntityHandle& Arena::CreateTorpedo(Player* owner, const Ndk::EntityHandle & emitter, const Nz::Vector3f & position, const Nz::Quaternionf & rotation)
 	{
-		const Ndk::EntityHandle& projectile = CreateEntity("torpedo", {}, owner, position, rotation);
+		const Ndk::EntityHandle& projectile = CreateEntity(m_torpedoArchetypeId, {}, owner, position, rotation);
 		projectile->GetComponent<ProjectileComponent>().MarkAsHit(emitter);
 
 		auto& projectilePhys = projectile->GetComponent<Ndk::PhysicsComponent3D>();
@@ -129,6 +146,17 @@ namespace ewn
 		return nullptr;
 	}
 
+	Player* Arena::FindPlayerBySession(std::size_t sessionId) const
+	{
+		for (Player* player : m_players)
+		{
+			if (player->GetSessionId() == sessionId)
+				return player;
+		}
+
+		return nullptr;
+	}
+
 	void Arena::HandleChatMessage(Player* sender, const std::string& message)
 	{
 		bool shouldPrintMessage = true;
@@ -137,10 +165,13 @@ namespace ewn
 			m_script.Push(sender);
 			m_script.Push(message);
 
-			if (!m_script.Call(2, 1))
+			if (m_script.Call(2, 1))
+			{
+				shouldPrintMessage = m_script.ToBoolean(-1);
+				m_script.Pop();
+			}
+			else
 				std::cerr << "An error occurred during OnPlayerChat call: " << m_script.GetLastError() << std::endl;
-
-			shouldPrintMessage = m_script.ToBoolean(-1);
 		}
 		else
 			m_script.Pop();
@@ -167,12 +198,12 @@ namespace ewn
 		Packets::ChatMessage chatPacket;
 		chatPacket.message = message;
 
-		for (Player* player : m_players)
-			player->SendPacket(chatPacket);
+		BroadcastPacket(chatPacket);
 	}
 
 	void Arena::Reload()
 	{
+		BuildArenaData();
 		LoadScript(m_scriptName);
 		Reset();
 	}
@@ -229,13 +260,20 @@ namespace ewn
 				return;
 			}
 
-			for (const auto& spaceship : fleet.spaceships)
+			PostCommand([this, fleet, spawnPos, spawnRot, sessionId]()
 			{
-				const auto& spaceshipTypeData = fleet.spaceshipTypes[spaceship.spaceshipType];
+				Player* owner = FindPlayerBySession(sessionId);
+				if (!owner)
+					return;
 
-				Nz::Vector3f position = spawnPos + spawnRot * spaceship.position;
-				SpawnSpaceship(ply, spaceshipTypeData.script, spaceshipTypeData.hullId, spaceshipTypeData.modules, position, spawnRot);
-			}
+				for (const auto& spaceship : fleet.spaceships)
+				{
+					const auto& spaceshipTypeData = fleet.spaceshipTypes[spaceship.spaceshipType];
+
+					Nz::Vector3f position = spawnPos + spawnRot * spaceship.position;
+					SpawnSpaceship(owner, spaceshipTypeData.script, spaceshipTypeData.hullId, spaceshipTypeData.modules, position, spawnRot);
+				}
+			});
 		});
 	}
 
@@ -296,6 +334,8 @@ namespace ewn
 
 	void Arena::Update(float elapsedTime)
 	{
+		ProcessCommands();
+
 		m_world.Update(elapsedTime);
 		for (Player* player : m_players)
 			player->Update(elapsedTime);
@@ -313,92 +353,39 @@ namespace ewn
 
 	const Ndk::EntityHandle& Arena::CreateEntity(std::string type, std::string name, Player* owner, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
 	{
-		const Ndk::EntityHandle& newEntity = m_world.CreateEntity();
-
-		if (type == "earth")
-		{
-			constexpr float radius = 50.f;
-
-			auto collider = Nz::SphereCollider3D::New(radius);
-
-			newEntity->AddComponent<Ndk::CollisionComponent3D>(Nz::SphereCollider3D::New(radius));
-			newEntity->AddComponent<Ndk::NodeComponent>().SetPosition(position);
-			newEntity->AddComponent<SignatureComponent>(newEntity->GetId(), 0.000035, collider->GetRadius(), collider->ComputeVolume());
-			newEntity->AddComponent<SynchronizedComponent>(0, type, name, false, 0);
-		}
-		else if (type == "light")
+		std::optional<Nz::UInt32> archetypeId = m_app->GetNetworkStringStore().FindStringIndex(type);
+		if (!archetypeId || m_entityArchetypes.find(*archetypeId) == m_entityArchetypes.end())
 		{
-			newEntity->AddComponent<SynchronizedComponent>(1, type, name, false, 0);
-
-			auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
-			node.SetPosition(position);
-			node.SetRotation(rotation);
+			std::cerr << "Unknown entity type \"" << type << "\"" << std::endl;
+			return Ndk::EntityHandle::InvalidHandle;
 		}
-		else if (type == "ball")
-		{
-			constexpr float radius = 18.251904f / 2.f;
 
-			auto collider = Nz::SphereCollider3D::New(radius);
-
-			newEntity->AddComponent<Ndk::CollisionComponent3D>(collider);
-			newEntity->AddComponent<SignatureComponent>(newEntity->GetId(), 0.0, collider->GetRadius(), collider->ComputeVolume());
-			newEntity->AddComponent<SynchronizedComponent>(4, type, name, true, 3);
+		return CreateEntity(*archetypeId, std::move(name), owner, position, rotation);
+	}
 
-			auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
-			node.SetPosition(position);
-			node.SetRotation(rotation);
+	const Ndk::EntityHandle& Arena::CreateEntity(Nz::UInt32 archetypeId, std::string name, Player* owner, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
+	{
+		auto it = m_entityArchetypes.find(archetypeId);
+		assert(it != m_entityArchetypes.end());
 
-			auto& physComponent = newEntity->AddComponent<Ndk::PhysicsComponent3D>();
-			physComponent.SetLinearDamping(0.05f);
-			physComponent.SetMass(100.f);
-			physComponent.SetPosition(position);
-			physComponent.SetRotation(rotation);
-		}
-		else if (type == "plasmabeam")
-		{
-			auto collider = Nz::CapsuleCollider3D::New(4.f, 0.5f, Nz::Vector3f::Zero(), Nz::EulerAnglesf(0.f, 90.f, 0.f));
+		const EntityArchetype& archetype = it->second;
 
-			newEntity->AddComponent<Ndk::CollisionComponent3D>(collider);
-			newEntity->AddComponent<LifeTimeComponent>(10.f);
-			newEntity->AddComponent<ProjectileComponent>(Nz::UInt16(50 + ((m_app->GetAppTime() % 21) - 10))); //< Aléatoire du pauvre
-			newEntity->AddComponent<SignatureComponent>(newEntity->GetId(), 10'000.0, collider->ComputeAABB().GetRadius(), collider->ComputeVolume());
-			newEntity->AddComponent<SynchronizedComponent>(2, type, name, true, 0);
+		const Ndk::EntityHandle& newEntity = m_world.CreateEntity();
 
-			auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
-			node.SetPosition(position);
-			node.SetRotation(rotation);
+		auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
+		node.SetPosition(position);
+		node.SetRotation(rotation);
 
-			auto& physComponent = newEntity->AddComponent<Ndk::PhysicsComponent3D>();
-			physComponent.SetAngularDamping(Nz::Vector3f::Zero());
-			physComponent.SetLinearDamping(0.f);
-			physComponent.SetMass(1.f);
-			physComponent.SetMaterial("plasma");
-			physComponent.SetPosition(position);
-			physComponent.SetRotation(rotation);
-		}
-		else if (type == "torpedo")
+		if (archetype.collider)
 		{
-			auto collider = Nz::SphereCollider3D::New(3.f);
-
-			newEntity->AddComponent<Ndk::CollisionComponent3D>(collider);
-			newEntity->AddComponent<LifeTimeComponent>(30.f);
-			newEntity->AddComponent<ProjectileComponent>(200);
-			newEntity->AddComponent<SignatureComponent>(newEntity->GetId(), 1'000.0, collider->GetRadius(), collider->ComputeVolume());
-			newEntity->AddComponent<SynchronizedComponent>(3, type, name, true, 0);
-
-			auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
-			node.SetPosition(position);
-			node.SetRotation(rotation);
-
-			auto& physComponent = newEntity->AddComponent<Ndk::PhysicsComponent3D>();
-			physComponent.SetAngularDamping(Nz::Vector3f::Zero());
-			physComponent.SetLinearDamping(0.f);
-			physComponent.SetMass(1.f);
-			physComponent.SetMaterial("torpedo");
-			physComponent.SetPosition(position);
-			physComponent.SetRotation(rotation);
+			newEntity->AddComponent<Ndk::CollisionComponent3D>(archetype.collider);
+			newEntity->AddComponent<SignatureComponent>(newEntity->GetId(), archetype.emSignature, archetype.signatureSize, archetype.signatureVolume);
 		}
 
+		if (archetype.setup)
+			archetype.setup(newEntity, position, rotation);
+
+		newEntity->AddComponent<SynchronizedComponent>(archetype.prefabId, archetypeId, std::move(name), archetype.movable, archetype.networkPriority);
 		newEntity->AddComponent<ArenaComponent>(*this);
 
 		if (owner)
@@ -501,7 +488,7 @@ namespace ewn
 
 		newEntity->AddComponent<InputComponent>();
 		newEntity->AddComponent<SignatureComponent>(signature, 42.0, collider->ComputeAABB().GetRadius(), collider->ComputeVolume());
-		newEntity->AddComponent<SynchronizedComponent>((spaceshipHullId == 1) ? 5 : 6, "spaceship", name, true, 5);
+		newEntity->AddComponent<SynchronizedComponent>((spaceshipHullId == 1) ? 5 : 6, m_spaceshipArchetypeId, name, true, 5);
 
 		auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
 		node.SetPosition(position);
@@ -550,6 +537,7 @@ namespace ewn
 			m_script.Pop();
 
 		player->ClearControlledEntity();
+		m_world.GetSystem<BroadcastSystem>().RemovePlayer(player);
 		m_players.erase(player);
 	}
 
@@ -559,10 +547,10 @@ namespace ewn
 
 		SendArenaData(player);
 
-		m_createEntitiesCache.entities.clear();
-		m_world.GetSystem<BroadcastSystem>().CreateAllEntities(m_createEntitiesCache);
+		player->ResetArenaStateSync();
 
-		player->SendPacket(m_createEntitiesCache);
+		// Entities will be sent as they become relevant to the player
+		m_world.GetSystem<BroadcastSystem>().AddPlayer(player);
 
 		m_players.insert(player);
 
@@ -577,8 +565,95 @@ namespace ewn
 			m_script.Pop();
 	}
 
+	void Arena::ProcessCommands()
+	{
+		Command command;
+		while (m_commandQueue.try_dequeue(command))
+			command();
+	}
+
+	void Arena::RegisterEntityArchetypes()
+	{
+		// Entity types are identified by their network string, so they can be looked up by id instead of comparing strings
+		const NetworkStringStore& stringStore = m_app->GetNetworkStringStore();
+
+		auto RegisterArchetype = [&](const std::string& type, std::size_t prefabId, bool movable, Nz::UInt16 networkPriority, Nz::Collider3DRef collider, double emSignature, double signatureSize, EntityArchetype::Setup setup = nullptr)
+		{
+			Nz::UInt32 archetypeId = stringStore.GetStringIndex(type);
+
+			EntityArchetype& archetype = m_entityArchetypes[archetypeId];
+			archetype.emSignature = emSignature;
+			archetype.movable = movable;
+			archetype.networkPriority = networkPriority;
+			archetype.prefabId = prefabId;
+			archetype.setup = std::move(setup);
+			archetype.signatureSize = signatureSize;
+			archetype.signatureVolume = (collider) ? collider->ComputeVolume() : 0.0;
+			archetype.collider = std::move(collider);
+
+			return archetypeId;
+		};
+
+		// Colliders are shared by every entity of an archetype, their signature data is computed once here
+		Nz::SphereCollider3DRef earthCollider = Nz::SphereCollider3D::New(50.f);
+		RegisterArchetype("earth", 0, false, 0, earthCollider, 0.000035, earthCollider->GetRadius());
+
+		RegisterArchetype("light", 1, false, 0, nullptr, 0.0, 0.0);
+
+		Nz::SphereCollider3DRef ballCollider = Nz::SphereCollider3D::New(18.251904f / 2.f);
+		RegisterArchetype("ball", 4, true, 3, ballCollider, 0.0, ballCollider->GetRadius(), [](const Ndk::EntityHandle& entity, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
+		{
+			auto& physComponent = entity->AddComponent<Ndk::PhysicsComponent3D>();
+			physComponent.SetLinearDamping(0.05f);
+			physComponent.SetMass(100.f);
+			physComponent.SetPosition(position);
+			physComponent.SetRotation(rotation);
+		});
+
+		Nz::CapsuleCollider3DRef plasmaBeamCollider = Nz::CapsuleCollider3D::New(4.f, 0.5f, Nz::Vector3f::Zero(), Nz::EulerAnglesf(0.f, 90.f, 0.f));
+		m_plasmaBeamArchetypeId = RegisterArchetype("plasmabeam", 2, true, 0, plasmaBeamCollider, 10'000.0, plasmaBeamCollider->ComputeAABB().GetRadius(), [this](const Ndk::EntityHandle& entity, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
+		{
+			entity->AddComponent<LifeTimeComponent>(10.f);
+			entity->AddComponent<ProjectileComponent>(Nz::UInt16(50 + ((m_app->GetAppTime() % 21) - 10))); //< Aléatoire du pauvre
+
+			auto& physComponent = entity->AddComponent<Ndk::PhysicsComponent3D>();
+			physComponent.SetAngularDamping(Nz::Vector3f::Zero());
+			physComponent.SetLinearDamping(0.f);
+			physComponent.SetMass(1.f);
+			physComponent.SetMaterial(m_plasmaMaterial);
+			physComponent.SetPosition(position);
+			physComponent.SetRotation(rotation);
+		});
+
+		Nz::SphereCollider3DRef torpedoCollider = Nz::SphereCollider3D::New(3.f);
+		m_torpedoArchetypeId = RegisterArchetype("torpedo", 3, true, 0, torpedoCollider, 1'000.0, torpedoCollider->GetRadius(), [this](const Ndk::EntityHandle& entity, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
+		{
+			entity->AddComponent<LifeTimeComponent>(30.f);
+			entity->AddComponent<ProjectileComponent>(200);
+
+			auto& physComponent = entity->AddComponent<Ndk::PhysicsComponent3D>();
+			physComponent.SetAngularDamping(Nz::Vector3f::Zero());
+			physComponent.SetLinearDamping(0.f);
+			physComponent.SetMass(1.f);
+			physComponent.SetMaterial(m_torpedoMaterial);
+			physComponent.SetPosition(position);
+			physComponent.SetRotation(rotation);
+		});
+
+		// Spaceships are built from their hull and modules by CreateSpaceship, their type is only used to identify them
+		m_spaceshipArchetypeId = stringStore.GetStringIndex("spaceship");
+	}
+
 	void Arena::SendArenaData(Player* player)
 	{
+		player->SendPacket(m_arenaParticleSystemsPacket);
+		player->SendPacket(m_arenaSoundsPacket);
+		player->SendPacket(m_arenaPrefabsPacket);
+	}
+
+	void Arena::BuildArenaData()
+	{
+		// Those tables never change while the arena is running, serialize them once and share the result with every joining player
 		Packets::ArenaParticleSystems arenaParticleSystems;
 		arenaParticleSystems.startId = 0;
 
@@ -592,7 +667,7 @@ namespace ewn
 		arenaParticleSystems.particleSystems.back().particleGroups.emplace_back();
 		arenaParticleSystems.particleSystems.back().particleGroups.back().particleGroupNameId = m_app->GetNetworkStringStore().GetStringIndex("explosion_wave");
 
-		player->SendPacket(arenaParticleSystems);
+		m_arenaParticleSystemsPacket = m_commandStore.SerializePacket(arenaParticleSystems);
 
 		Packets::ArenaSounds arenaSoundsPacket;
 		arenaSoundsPacket.startId = 0;
@@ -609,7 +684,7 @@ namespace ewn
 		arenaSoundsPacket.sounds.emplace_back();
 		arenaSoundsPacket.sounds.back().filePath = "sounds/plasmabeam_loop.wav";
 
-		player->SendPacket(arenaSoundsPacket);
+		m_arenaSoundsPacket = m_commandStore.SerializePacket(arenaSoundsPacket);
 
 		Packets::ArenaPrefabs arenaPrefabsPacket;
 		arenaPrefabsPacket.startId = 0;
@@ -684,7 +759,7 @@ namespace ewn
 		arenaPrefabsPacket.prefabs.back().models.back().rotation = Nz::EulerAnglesf(0.f, 90.f, 0.f);
 		arenaPrefabsPacket.prefabs.back().models.back().scale = Nz::Vector3f(0.1f);
 
-		player->SendPacket(arenaPrefabsPacket);
+		m_arenaPrefabsPacket = m_commandStore.SerializePacket(arenaPrefabsPacket);
 	}
 
 	void Arena::SpawnSpaceship(Player* owner, Nz::Int32 spaceshipId, std::string code, std::size_t spaceshipHullId, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
@@ -720,7 +795,11 @@ namespace ewn
 				return;
 			}
 
-			SpawnSpaceship(ply, std::move(spaceshipCode), spaceshipHullId, moduleIds, position, rotation);
+			PostCommand([this, position, rotation, sessionId, spaceshipHullId, spaceshipCode = std::move(spaceshipCode), moduleIds = std::move(moduleIds)]() mutable
+			{
+				if (Player* owner = FindPlayerBySession(sessionId))
+					SpawnSpaceship(owner, std::move(spaceshipCode), spaceshipHullId, moduleIds, position, rotation);
+			});
 		});
 	}
 
@@ -850,37 +929,29 @@ namespace ewn
 		// Apply physics force
 		auto& projectilePhys = projectile->GetComponent<Ndk::PhysicsComponent3D>();
 
-		Nz::PhysWorld3D& physWorld = m_world.GetSystem<Ndk::PhysicsSystem3D>().GetWorld();
-
 		float explosionRadius = 50.f;
 		Nz::Vector3f torpedoPosition = projectilePhys.GetPosition();
-		Nz::Boxf detectionBox = Nz::Boxf(torpedoPosition - Nz::Vector3f(explosionRadius), torpedoPosition + Nz::Vector3f(explosionRadius));
 
-		float maxSquaredRadius = explosionRadius * explosionRadius;
-		physWorld.ForEachBodyInAABB(detectionBox, [&](Nz::RigidBody3D& body)
+		m_world.GetSystem<BroadphaseSystem>().ForEachInSphere(torpedoPosition, explosionRadius, [&](const BroadphaseSystem::EntityData& entityData)
 		{
-			Nz::Vector3f bodyPosition = body.GetPosition();
-			if (bodyPosition.SquaredDistance(torpedoPosition) < maxSquaredRadius)
-			{
-				Ndk::EntityId bodyId = static_cast<Ndk::EntityId>(reinterpret_cast<std::ptrdiff_t>(body.GetUserdata()));
-				const Ndk::EntityHandle& bodyEntity = m_world.GetEntity(bodyId);
+			const Ndk::EntityHandle& bodyEntity = m_world.GetEntity(entityData.id);
 
-				float fade = std::clamp(bodyPosition.Distance(torpedoPosition) / explosionRadius, 0.f, 1.f);
+			float fade = std::clamp(entityData.position.Distance(torpedoPosition) / explosionRadius, 0.f, 1.f);
 
-				if (bodyEntity->HasComponent<HealthComponent>())
-				{
-					auto& health = bodyEntity->GetComponent<HealthComponent>();
-					health.Damage(static_cast<Nz::UInt16>(projectileComponent.GetDamageValue() / fade), projectile);
-				}
+			if (bodyEntity->HasComponent<HealthComponent>())
+			{
+				auto& health = bodyEntity->GetComponent<HealthComponent>();
+				health.Damage(static_cast<Nz::UInt16>(projectileComponent.GetDamageValue() / fade), projectile);
+			}
 
-				Nz::Vector3f force = bodyPosition - torpedoPosition;
+			if (bodyEntity->HasComponent<Ndk::PhysicsComponent3D>())
+			{
+				Nz::Vector3f force = entityData.position - torpedoPosition;
 				force.Normalize();
 				force *= 500'000.f / fade;
 
-				body.AddForce(force);
+				bodyEntity->GetComponent<Ndk::PhysicsComponent3D>().AddForce(force);
 			}
-
-			return true;
 		});
 
 		projectile->Kill(); //< Remember entity destruction is not immediate, we can still use it safely
@@ -888,29 +959,9 @@ namespace ewn
 		return false;
 	}
 
-	void Arena::OnBroadcastEntitiesCreation(const BroadcastSystem* /*system*/, const Packets::CreateEntities& packet)
-	{
-		for (Player* player : m_players)
-			player->SendPacket(packet);
-	}
-
-	void Arena::OnBroadcastEntitiesDestruction(const BroadcastSystem* /*system*/, const Packets::DeleteEntities& packet)
+	void Arena::OnBroadcastStateUpdate(const BroadcastSystem* /*system*/, Player* player, Packets::ArenaState& statePacket)
 	{
-		for (Player* player : m_players)
-			player->SendPacket(packet);
-	}
-
-	void Arena::OnBroadcastStateUpdate(const BroadcastSystem* /*system*/, Packets::ArenaState& statePacket)
-	{
-		static Nz::UInt16 snapshotId = 0;
-		statePacket.stateId = snapshotId++;
-
-		for (Player* player : m_players)
-		{
-			statePacket.lastProcessedInputTime = player->GetLastInputProcessedTime();
-
-			player->SendPacket(statePacket);
-		}
+		player->SendArenaState(statePacket);
 
 		if constexpr (sendServerGhosts)
 		{
@@ -9,12 +9,16 @@
 
 #include <Nazara/Core/Clock.hpp>
 #include <Nazara/Lua/LuaInstance.hpp>
+#include <Nazara/Physics3D/Collider3D.hpp>
 #include <NDK/EntityList.hpp>
 #include <NDK/EntityOwner.hpp>
 #include <NDK/World.hpp>
 #include <Shared/NetworkReactor.hpp>
 #include <Shared/Protocol/Packets.hpp>
 #include <Server/ServerCommandStore.hpp>
+#include <concurrentqueue/concurrentqueue.h>
+#include <hopstotch/hopscotch_map.h>
+#include <functional>
 #include <unordered_set>
 #include <vector>
 
@@ -34,6 +38,8 @@ namespace ewn
 		friend Player;
 
 		public:
+			using Command = std::function<void()>;
+
 			Arena(ServerApplication* app, std::string name, std::string scriptName);
 			Arena(const Arena&) = delete;
 			Arena(Arena&&) = delete;
@@ -42,12 +48,16 @@ namespace ewn
 			template<typename T>
 			void BroadcastPacket(const T& packet, Player* exceptPlayer = nullptr);
 
+			std::vector<std::string> BuildScriptStatsReport(std::size_t maxOwnerCount);
+
 			const Ndk::EntityHandle& CreateEntity(std::string type, std::string name, Player* owner, const Nz::Vector3f& position, const Nz::Quaternionf& rotation);
+			const Ndk::EntityHandle& CreateEntity(Nz::UInt32 archetypeId, std::string name, Player* owner, const Nz::Vector3f& position, const Nz::Quaternionf& rotation);
 			const Ndk::EntityHandle& CreatePlasmaProjectile(Player* owner, const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation);
 			const Ndk::EntityHandle& CreateSpaceship(std::string name, Player* owner, std::size_t spaceshipHullId, const Nz::Vector3f& position, const Nz::Quaternionf& rotation);
 			const Ndk::EntityHandle& CreateTorpedo(Player* owner, const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation);
 
 			Player* FindPlayerByName(const std::string& name) const;
+			Player* FindPlayerBySession(std::size_t sessionId) const;
 
 			inline const Ndk::EntityHandle& GetEntity(Ndk::EntityId entityId);
 			inline Nz::LuaInstance& GetLuaInstance();
@@ -57,6 +67,8 @@ namespace ewn
 
 			inline bool IsEntityIdValid(Ndk::EntityId entityId) const;
 
+			inline void PostCommand(Command command);
+
 			void PrintChatMessage(const std::string& message);
 
 			void Reload();
@@ -75,6 +87,24 @@ namespace ewn
 			Arena& operator=(Arena&&) = delete;
 
 		private:
+			using CommandQueue = moodycamel::ConcurrentQueue<Command>;
+
+			struct EntityArchetype
+			{
+				using Setup = std::function<void(const Ndk::EntityHandle& entity, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)>;
+
+				Nz::Collider3DRef collider;
+				Setup setup; //< adds type-specific components
+				double emSignature;
+				double signatureSize;
+				double signatureVolume;
+				std::size_t prefabId;
+				Nz::UInt16 networkPriority;
+				bool movable;
+			};
+
+			void BuildArenaData();
+
 			bool LoadScript(std::string fileName);
 
 			void HandlePlayerLeave(Player* player);
@@ -84,9 +114,11 @@ namespace ewn
 			bool HandlePlasmaProjectileCollision(const Nz::RigidBody3D& firstBody, const Nz::RigidBody3D& secondBody);
 			bool HandleTorpedoProjectileCollision(const Nz::RigidBody3D& firstBody, const Nz::RigidBody3D& secondBody);
 
-			void OnBroadcastEntitiesCreation(const BroadcastSystem* system, const Packets::CreateEntities& packet);
-			void OnBroadcastEntitiesDestruction(const BroadcastSystem* system, const Packets::DeleteEntities& packet);
-			void OnBroadcastStateUpdate(const BroadcastSystem* system, Packets::ArenaState& statePacket);
+			void OnBroadcastStateUpdate(const BroadcastSystem* system, Player* player, Packets::ArenaState& statePacket);
+
+			void ProcessCommands();
+
+			void RegisterEntityArchetypes();
 
 			void SendArenaData(Player* player);
 
@@ -97,10 +129,18 @@ namespace ewn
 			std::string m_name;
 			std::string m_scriptName;
 			std::unordered_set<Player*> m_players;
-			Packets::CreateEntities m_createEntitiesCache;
+			tsl::hopscotch_map<Nz::UInt32, EntityArchetype> m_entityArchetypes;
+			CommandQueue m_commandQueue;
+			SharedPacket m_arenaParticleSystemsPacket;
+			SharedPacket m_arenaPrefabsPacket;
+			SharedPacket m_arenaSoundsPacket;
+			const ServerCommandStore& m_commandStore;
 			ServerApplication* m_app;
 			int m_plasmaMaterial;
 			int m_torpedoMaterial;
+			Nz::UInt32 m_plasmaBeamArchetypeId;
+			Nz::UInt32 m_spaceshipArchetypeId;
+			Nz::UInt32 m_torpedoArchetypeId;
 	};
 }
 
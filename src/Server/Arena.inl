@@ -10,10 +10,12 @@ namespace ewn
 	template<typename T>
 	void Arena::BroadcastPacket(const T& packet, Player* exceptPlayer)
 	{
+		SharedPacket sharedPacket = m_commandStore.SerializePacket(packet);
+
 		for (Player* player : m_players)
 		{
 			if (player != exceptPlayer)
-				player->SendPacket(packet);
+				player->SendPacket(sharedPacket);
 		}
 	}
 
@@ -37,4 +39,10 @@ namespace ewn
 	{
 		return m_world.IsEntityIdValid(entityId);
 	}
+
+	inline void Arena::PostCommand(Command command)
+	{
+		// Arena may be running on its own thread, commands are executed at the beginning of its next update
+		m_commandQueue.enqueue(std::move(command));
+	}
 }
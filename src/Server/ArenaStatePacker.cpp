@@ -0,0 +1,27 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/ArenaStatePacker.hpp>
+
+namespace ewn
+{
+	void ArenaStatePacker::SelectEntities()
+	{
+		// No more than maxEntityPerUpdate entities can fit in our states, only select and sort those
+		const std::size_t maxEntityPerUpdate = MaxStatesPerUpdate * StateMaxSize / ArenaStateHistory::ComputeEntitySize(EntityStateFieldFlags{});
+
+		auto priorityCompare = [](const EntityPriority& lhs, const EntityPriority& rhs)
+		{
+			return lhs.priority > rhs.priority;
+		};
+
+		if (m_priorityQueue.size() > maxEntityPerUpdate)
+		{
+			std::nth_element(m_priorityQueue.begin(), m_priorityQueue.begin() + maxEntityPerUpdate, m_priorityQueue.end(), priorityCompare);
+			m_priorityQueue.resize(maxEntityPerUpdate);
+		}
+
+		std::sort(m_priorityQueue.begin(), m_priorityQueue.end(), priorityCompare);
+	}
+}
@@ -0,0 +1,51 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_ARENASTATEPACKER_HPP
+#define EREWHON_SERVER_ARENASTATEPACKER_HPP
+
+#include <Shared/Protocol/Packets.hpp>
+#include <vector>
+
+namespace ewn
+{
+	// Selects the highest priority entities of a player and packs them into as many arena states as its bandwidth allows
+	// Doesn't depend on the world or on players, so it can also be benchmarked on its own
+	class ArenaStatePacker
+	{
+		public:
+			ArenaStatePacker() = default;
+			~ArenaStatePacker() = default;
+
+			inline void Clear();
+
+			template<typename B, typename S> void PackStates(Packets::ArenaState& statePacket, std::size_t recordsSize, float& bandwidthCredit, B&& getBaseline, S&& sendState);
+
+			inline void QueueEntity(const Packets::ArenaState::Entity& entityState, Nz::UInt16 priority);
+
+			static inline Nz::UInt16 AccumulatePriority(Nz::UInt16 accumulator, Nz::UInt16 priority, float priorityFactor);
+
+			static constexpr std::size_t MaxStatesPerUpdate = 4;
+			static constexpr std::size_t StateMaxSize = 1300; //< Keep states under the usual MTU
+			static constexpr std::size_t RecordsMaxSize = StateMaxSize / 2;
+			static constexpr std::size_t StateOverhead = 32; //< Estimation of state and header packets size without entities
+
+		private:
+			void SelectEntities();
+
+			struct EntityPriority
+			{
+				const Packets::ArenaState::Entity* state;
+				Nz::UInt16 priority;
+			};
+
+			std::vector<EntityPriority> m_priorityQueue;
+	};
+}
+
+#include <Server/ArenaStatePacker.inl>
+
+#endif // EREWHON_SERVER_ARENASTATEPACKER_HPP
@@ -0,0 +1,113 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/ArenaStatePacker.hpp>
+#include <Shared/Protocol/ArenaStateHistory.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace ewn
+{
+	inline void ArenaStatePacker::Clear()
+	{
+		m_priorityQueue.clear();
+	}
+
+	template<typename B, typename S>
+	void ArenaStatePacker::PackStates(Packets::ArenaState& statePacket, std::size_t recordsSize, float& bandwidthCredit, B&& getBaseline, S&& sendState)
+	{
+		// Entity records already in statePacket (recordsSize being their estimated size) only go in the first state
+		// getBaseline returns what the next state will be delta-encoded against (or nullptr), sendState is called with every filled state
+		SelectEntities();
+
+		// Fill states by priority order, each one up to StateMaxSize bytes, as long as the player has bandwidth credit
+		// Players receive a delta against the last state they acknowledged (or a full state without one), estimate entity size the same way
+		const Packets::ArenaState* baseline;
+		std::size_t stateSize;
+		float stateBudget;
+
+		auto beginState = [&]()
+		{
+			// Records which were already sent are never dropped and may exceed RecordsMaxSize, entities always keep their share of the state
+			std::size_t entityMaxSize = StateMaxSize - std::min(recordsSize, RecordsMaxSize);
+
+			baseline = getBaseline();
+			stateSize = 0;
+			stateBudget = std::clamp(bandwidthCredit - StateOverhead - recordsSize, 0.f, float(entityMaxSize));
+			bandwidthCredit -= StateOverhead + recordsSize;
+		};
+
+		auto flushState = [&]()
+		{
+			// Delta compression requires states to be sorted by entity id
+			std::sort(statePacket.entities.begin(), statePacket.entities.end(), [](const Packets::ArenaState::Entity& lhs, const Packets::ArenaState::Entity& rhs)
+			{
+				return lhs.id < rhs.id;
+			});
+
+			sendState(statePacket);
+
+			statePacket.entities.clear();
+
+			// Following states of this update only carry entities
+			statePacket.createdEntities.clear();
+			statePacket.deletedEntities.clear();
+			recordsSize = 0;
+		};
+
+		// Always send at least one state (even empty) so the player keeps receiving its last processed input time
+		std::size_t stateCount = 1;
+		beginState();
+
+		for (const EntityPriority& priority : m_priorityQueue)
+		{
+			const Packets::ArenaState::Entity& entityData = *priority.state;
+
+			EntityStateFieldFlags changedFields = EntityStateFieldFlags::ValueMask;
+			if (baseline)
+			{
+				auto it = std::lower_bound(baseline->entities.begin(), baseline->entities.end(), entityData.id, [](const Packets::ArenaState::Entity& entity, Nz::UInt32 entityId)
+				{
+					return entity.id < entityId;
+				});
+
+				if (it != baseline->entities.end() && it->id == entityData.id)
+					changedFields = ArenaStateHistory::ComputeChangedFields(*it, entityData);
+			}
+
+			std::size_t entitySize = ArenaStateHistory::ComputeEntitySize(changedFields);
+			if (stateSize + entitySize > stateBudget)
+			{
+				// Start a new state if bandwidth allows it
+				if (stateCount >= MaxStatesPerUpdate || bandwidthCredit < StateOverhead + recordsSize + entitySize)
+					break;
+
+				flushState();
+
+				stateCount++;
+				beginState();
+			}
+
+			stateSize += entitySize;
+			bandwidthCredit -= entitySize;
+
+			statePacket.entities.push_back(entityData);
+		}
+
+		flushState();
+	}
+
+	inline void ArenaStatePacker::QueueEntity(const Packets::ArenaState::Entity& entityState, Nz::UInt16 priority)
+	{
+		auto& priorityData = m_priorityQueue.emplace_back();
+		priorityData.state = &entityState;
+		priorityData.priority = priority;
+	}
+
+	inline Nz::UInt16 ArenaStatePacker::AccumulatePriority(Nz::UInt16 accumulator, Nz::UInt16 priority, float priorityFactor)
+	{
+		unsigned int newPriority = accumulator + static_cast<unsigned int>(priority * priorityFactor);
+		return static_cast<Nz::UInt16>(std::min<unsigned int>(newPriority, std::numeric_limits<Nz::UInt16>::max()));
+	}
+}
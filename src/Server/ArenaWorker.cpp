@@ -0,0 +1,26 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/ArenaWorker.hpp>
+#include <Server/Arena.hpp>
+#include <Server/TickScheduler.hpp>
+
+namespace ewn
+{
+	void ArenaWorker::WorkerThread()
+	{
+		// Don't try to catch up more than a few ticks behind, just drop them
+		constexpr unsigned int MaxCatchUpTicks = 5;
+
+		TickScheduler tickScheduler(m_tickRate, MaxCatchUpTicks);
+		float tickDuration = tickScheduler.GetTickDuration();
+
+		while (m_running.load(std::memory_order_acquire))
+		{
+			unsigned int tickCount = tickScheduler.WaitNextTick();
+			for (unsigned int i = 0; i < tickCount; ++i)
+				m_arena.Update(tickDuration);
+		}
+	}
+}
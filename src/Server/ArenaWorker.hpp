@@ -0,0 +1,41 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_ARENAWORKER_HPP
+#define EREWHON_SERVER_ARENAWORKER_HPP
+
+#include <Nazara/Prerequisites.hpp>
+#include <Nazara/Core/Thread.hpp>
+#include <atomic>
+
+namespace ewn
+{
+	class Arena;
+
+	class ArenaWorker final
+	{
+		public:
+			inline ArenaWorker(Arena& arena, unsigned int tickRate);
+			ArenaWorker(const ArenaWorker&) = delete;
+			ArenaWorker(ArenaWorker&&) = delete;
+			inline ~ArenaWorker();
+
+			ArenaWorker& operator=(const ArenaWorker&) = delete;
+			ArenaWorker& operator=(ArenaWorker&&) = delete;
+
+		private:
+			void WorkerThread();
+
+			Arena& m_arena;
+			std::atomic_bool m_running;
+			Nz::Thread m_thread;
+			unsigned int m_tickRate;
+	};
+}
+
+#include <Server/ArenaWorker.inl>
+
+#endif // EREWHON_SERVER_ARENAWORKER_HPP
@@ -0,0 +1,23 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/ArenaWorker.hpp>
+
+namespace ewn
+{
+	inline ArenaWorker::ArenaWorker(Arena& arena, unsigned int tickRate) :
+	m_arena(arena),
+	m_running(true),
+	m_tickRate(tickRate)
+	{
+		m_thread = Nz::Thread(&ArenaWorker::WorkerThread, this);
+		m_thread.SetName("ArenaWorker");
+	}
+
+	inline ArenaWorker::~ArenaWorker()
+	{
+		m_running.store(false, std::memory_order_release);
+		m_thread.Join();
+	}
+}
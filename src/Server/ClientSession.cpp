@@ -10,10 +10,12 @@
 #include <Server/Player.hpp>
 #include <Server/ServerApplication.hpp>
 #include <argon2/argon2.h>
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <cctype>
 #include <iostream>
+#include <limits>
 #include <regex>
 
 namespace ewn
@@ -24,8 +26,27 @@ namespace ewn
 	m_sessionId(sessionId),
 	m_app(app),
 	m_networkReactor(reactor),
-	m_commandStore(commandStore)
+	m_commandStore(commandStore),
+	m_recentPingIndex(0),
+	m_lastTotalPacketLost(0),
+	m_lastTotalPacketSent(0)
 	{
+		m_recentPings.fill(std::numeric_limits<Nz::UInt32>::max());
+
+		// Start slow, bandwidth will increase as long as the connection doesn't show congestion
+		m_player->UpdateStateBandwidth(m_app->GetConfig().GetIntegerOption<Nz::UInt32>("Game.MinStateBandwidth"));
+	}
+
+	void ClientSession::HandleArenaStateAck(const Packets::ArenaStateAck& data)
+	{
+		Player* player = GetPlayer();
+		if (!player->IsAuthenticated())
+			return;
+
+		player->PostArenaCommand([player, stateId = data.stateId]()
+		{
+			player->AcknowledgeArenaState(stateId);
+		});
 	}
 
 	void ClientSession::HandleControlEntity(const Packets::ControlEntity& data)
@@ -34,21 +55,22 @@ namespace ewn
 		if (!player->IsAuthenticated())
 			return;
 
-		if (Arena* arena = player->GetArena())
+		player->PostArenaCommand([player, peerId = m_peerId, controlledId = data.id]()
 		{
-			if (data.id != 0)
+			Arena* arena = player->GetArena();
+			if (controlledId != 0)
 			{
-				Ndk::EntityId entityId = static_cast<Ndk::EntityId>(data.id);
+				Ndk::EntityId entityId = static_cast<Ndk::EntityId>(controlledId);
 				if (!arena->IsEntityIdValid(entityId))
 				{
-					std::cerr << "Client #" << m_peerId << " tried to control invalid entity #" << entityId << std::endl;
+					std::cerr << "Client #" << peerId << " tried to control invalid entity #" << entityId << std::endl;
 					return;
 				}
 
 				const Ndk::EntityHandle& entity = arena->GetEntity(entityId);
 				if (!entity->HasComponent<OwnerComponent>() || entity->GetComponent<OwnerComponent>().GetOwner() != player)
 				{
-					std::cerr << "Client #" << m_peerId << " tried to control entity #" << entityId << " which doesn't belong to them" << std::endl;
+					std::cerr << "Client #" << peerId << " tried to control entity #" << entityId << " which doesn't belong to them" << std::endl;
 					return;
 				}
 
@@ -56,7 +78,7 @@ namespace ewn
 			}
 			else
 				player->UpdateControlledEntity(Ndk::EntityHandle::InvalidHandle);
-		}
+		});
 	}
 
 	void ClientSession::HandleCreateFleet(const Packets::CreateFleet& data)
@@ -624,8 +646,7 @@ namespace ewn
 		if (!player->IsAuthenticated())
 			return;
 
-		if (player->GetArena())
-			player->MoveToArena(nullptr);
+		player->MoveToArena(nullptr);
 	}
 
 	void ClientSession::HandleJoinArena(const Packets::JoinArena& data)
@@ -637,9 +658,7 @@ namespace ewn
 		if (data.arenaIndex > m_app->GetArenaCount())
 			return;
 
-		Arena* arena = m_app->GetArena(data.arenaIndex);
-		if (player->GetArena() != arena)
-			player->MoveToArena(arena);
+		player->MoveToArena(m_app->GetArena(data.arenaIndex));
 	}
 
 	void ClientSession::HandlePlayerChat(const Packets::PlayerChat& data)
@@ -651,23 +670,30 @@ namespace ewn
 		if (data.text.empty())
 			return;
 
-		if (data.text[0] == '/')
+		auto HandleChat = [app = m_app, player, text = data.text]()
 		{
-			std::string_view command = data.text;
-			command.remove_prefix(1);
-
-			std::optional<bool> result = m_app->GetChatCommandStore().ExecuteCommand(player, command);
-			if (result)
+			if (text[0] == '/')
 			{
-				if (!*result)
-					player->PrintMessage("Error in parsing command, you may be missing parameters");
+				std::string_view command = text;
+				command.remove_prefix(1);
+
+				std::optional<bool> result = app->GetChatCommandStore().ExecuteCommand(player, command);
+				if (result)
+				{
+					if (!*result)
+						player->PrintMessage("Error in parsing command, you may be missing parameters");
 
-				return; // Don't show command if it was recognized
+					return; // Don't show command if it was recognized
+				}
 			}
-		}
 
-		if (Arena* arena = player->GetArena())
-			arena->HandleChatMessage(player, data.text);
+			if (Arena* arena = player->GetArena())
+				arena->HandleChatMessage(player, text);
+		};
+
+		// Most chat commands act on the arena, run them from its thread
+		if (!player->PostArenaCommand(HandleChat))
+			HandleChat();
 	}
 
 	void ClientSession::HandlePlayerMovement(const Packets::PlayerMovement& data)
@@ -676,7 +702,10 @@ namespace ewn
 		if (!player->IsAuthenticated())
 			return;
 
-		player->UpdateInput(data.inputTime, data.direction, data.rotation);
+		player->PostArenaCommand([player, inputTime = data.inputTime, direction = data.direction, rotation = data.rotation]()
+		{
+			player->UpdateInput(inputTime, direction, rotation);
+		});
 	}
 
 	void ClientSession::HandlePlayerShoot(const Packets::PlayerShoot& data)
@@ -685,7 +714,10 @@ namespace ewn
 		if (!player->IsAuthenticated())
 			return;
 
-		player->Shoot();
+		player->PostArenaCommand([player]()
+		{
+			player->Shoot();
+		});
 	}
 
 	void ClientSession::HandleQueryArenaList(const Packets::QueryArenaList& data)
@@ -1417,4 +1449,37 @@ namespace ewn
 		});
 	}
 
+	void ClientSession::UpdateInfo(const NetworkReactor::PeerInfo& peerInfo)
+	{
+		// Congestion is either packet loss or round trip time growing well above its lowest value (which is what ENet throttling reacts to)
+		constexpr Nz::UInt32 MaxLossPercent = 2;
+		constexpr Nz::UInt32 PingTolerance = 50;
+
+		Nz::UInt32 lostPackets = peerInfo.totalPacketLost - m_lastTotalPacketLost;
+		Nz::UInt32 sentPackets = peerInfo.totalPacketSent - m_lastTotalPacketSent;
+		m_lastTotalPacketLost = peerInfo.totalPacketLost;
+		m_lastTotalPacketSent = peerInfo.totalPacketSent;
+
+		// Use the lowest round trip time over the last few seconds, so the baseline follows route changes instead of sticking to its all-time lowest value
+		m_recentPings[m_recentPingIndex] = peerInfo.ping;
+		m_recentPingIndex = (m_recentPingIndex + 1) % m_recentPings.size();
+
+		Nz::UInt32 lowestPing = *std::min_element(m_recentPings.begin(), m_recentPings.end());
+
+		bool congested = (lostPackets * 100 > sentPackets * MaxLossPercent) || (peerInfo.ping > 2 * lowestPing + PingTolerance);
+
+		const ConfigFile& config = m_app->GetConfig();
+		Nz::UInt32 minBandwidth = config.GetIntegerOption<Nz::UInt32>("Game.MinStateBandwidth");
+		Nz::UInt32 maxBandwidth = config.GetIntegerOption<Nz::UInt32>("Game.MaxStateBandwidth");
+
+		// Additive increase, multiplicative decrease
+		Nz::UInt32 bandwidth = m_player->GetStateBandwidth();
+		if (congested)
+			bandwidth -= bandwidth / 4;
+		else
+			bandwidth += std::max((maxBandwidth - minBandwidth) / 8, 1U);
+
+		m_player->UpdateStateBandwidth(std::clamp(bandwidth, minBandwidth, maxBandwidth));
+	}
+
 }
@@ -9,6 +9,7 @@
 
 #include <Shared/NetworkReactor.hpp>
 #include <Server/ServerCommandStore.hpp>
+#include <array>
 
 namespace ewn
 {
@@ -31,9 +32,13 @@ namespace ewn
 			inline const Player* GetPlayer() const;
 			inline std::size_t GetSessionId() const;
 
+			inline void QueryInfo();
+
 			template<typename T> void SendPacket(const T& packet);
+			inline void SendPacket(const SharedPacket& packet);
 
 		private:
+			void HandleArenaStateAck(const Packets::ArenaStateAck& data);
 			void HandleControlEntity(const Packets::ControlEntity& data);
 			void HandleCreateFleet(const Packets::CreateFleet& data);
 			void HandleCreateSpaceship(const Packets::CreateSpaceship& data);
@@ -59,12 +64,20 @@ namespace ewn
 			void HandleUpdateFleet(const Packets::UpdateFleet& data);
 			void HandleUpdateSpaceship(const Packets::UpdateSpaceship& data);
 
+			void UpdateInfo(const NetworkReactor::PeerInfo& peerInfo);
+
+			static constexpr std::size_t PingWindowSize = 20; //< 10s of peer info queries
+
 			std::shared_ptr<Player> m_player;
 			std::size_t m_peerId;
 			std::size_t m_sessionId;
 			ServerApplication* m_app;
 			NetworkReactor& m_networkReactor;
 			const ServerCommandStore& m_commandStore;
+			std::array<Nz::UInt32, PingWindowSize> m_recentPings;
+			std::size_t m_recentPingIndex;
+			Nz::UInt32 m_lastTotalPacketLost;
+			Nz::UInt32 m_lastTotalPacketSent;
 	};
 }
 
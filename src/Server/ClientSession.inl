@@ -34,6 +34,11 @@ namespace ewn
 		return m_sessionId;
 	}
 
+	inline void ClientSession::QueryInfo()
+	{
+		m_networkReactor.QueryInfo(m_peerId);
+	}
+
 	template<typename T>
 	void ClientSession::SendPacket(const T& packet)
 	{
@@ -44,4 +49,9 @@ namespace ewn
 
 		m_networkReactor.SendData(m_peerId, command.channelId, command.flags, std::move(data));
 	}
+
+	inline void ClientSession::SendPacket(const SharedPacket& packet)
+	{
+		m_networkReactor.SendData(m_peerId, packet);
+	}
 }
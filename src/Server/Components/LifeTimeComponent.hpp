@@ -16,14 +16,16 @@ namespace ewn
 		public:
 			inline LifeTimeComponent(float durationInSeconds);
 
-			inline bool DecreaseDuration(float timeInSeconds);
+			inline float GetDuration() const;
+			inline Nz::UInt64 GetExpirationTick() const;
 
-			inline float GetRemainingDuration() const;
+			inline void SetExpirationTick(Nz::UInt64 tick);
 
 			static Ndk::ComponentIndex componentIndex;
 
 		private:
-			float m_remainingDuration;
+			Nz::UInt64 m_expirationTick; //< LifeTimeSystem tick at which the entity gets killed
+			float m_duration;
 	};
 }
 
@@ -7,18 +7,23 @@
 namespace ewn
 {
 	inline LifeTimeComponent::LifeTimeComponent(float durationInSeconds) :
-	m_remainingDuration(durationInSeconds)
+	m_expirationTick(0),
+	m_duration(durationInSeconds)
 	{
 	}
 
-	inline bool LifeTimeComponent::DecreaseDuration(float timeInSeconds)
+	inline float LifeTimeComponent::GetDuration() const
 	{
-		m_remainingDuration -= timeInSeconds;
-		return m_remainingDuration <= 0.f;
+		return m_duration;
 	}
 
-	inline float LifeTimeComponent::GetRemainingDuration() const
+	inline Nz::UInt64 LifeTimeComponent::GetExpirationTick() const
 	{
-		return m_remainingDuration;
+		return m_expirationTick;
+	}
+
+	inline void LifeTimeComponent::SetExpirationTick(Nz::UInt64 tick)
+	{
+		m_expirationTick = tick;
 	}
 }
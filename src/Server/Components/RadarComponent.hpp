@@ -0,0 +1,59 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_RADARCOMPONENT_HPP
+#define EREWHON_SERVER_RADARCOMPONENT_HPP
+
+#include <Nazara/Core/Signal.hpp>
+#include <NDK/Component.hpp>
+#include <NDK/Entity.hpp>
+#include <Server/Systems/BroadphaseSystem.hpp>
+#include <vector>
+
+namespace ewn
+{
+	class RadarComponent : public Ndk::Component<RadarComponent>
+	{
+		public:
+			struct Contact;
+
+			inline RadarComponent(float detectionRadius);
+			inline RadarComponent(const RadarComponent& radar);
+
+			inline void EnablePassiveScan(bool enable);
+
+			inline std::vector<Contact>& GetContacts();
+			inline const std::vector<Contact>& GetContacts() const;
+			inline float GetDetectionRadius() const;
+			inline Nz::UInt64 GetLastScanTime() const;
+
+			inline bool IsPassiveScanEnabled() const;
+
+			inline void SetLastScanTime(Nz::UInt64 scanTime);
+
+			struct Contact
+			{
+				Ndk::EntityHandle entity; //< invalid once the entity has been destroyed
+				Ndk::EntityId entityId;
+				Nz::Int64 signature;
+				bool hasSignature;
+			};
+
+			static Ndk::ComponentIndex componentIndex;
+
+			NazaraSignal(OnContactsUpdate, RadarComponent* /*radar*/, const Nz::Vector3f& /*radarPosition*/, const std::vector<const BroadphaseSystem::EntityData*>& /*newContacts*/, const std::vector<Contact>& /*lostContacts*/);
+
+		private:
+			std::vector<Contact> m_contacts; //< sorted by entity id
+			Nz::UInt64 m_lastScanTime;
+			float m_detectionRadius;
+			bool m_isPassiveScanEnabled;
+	};
+}
+
+#include <Server/Components/RadarComponent.inl>
+
+#endif // EREWHON_SERVER_RADARCOMPONENT_HPP
@@ -0,0 +1,58 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Components/RadarComponent.hpp>
+
+namespace ewn
+{
+	inline RadarComponent::RadarComponent(float detectionRadius) :
+	m_lastScanTime(0),
+	m_detectionRadius(detectionRadius),
+	m_isPassiveScanEnabled(true)
+	{
+	}
+
+	inline RadarComponent::RadarComponent(const RadarComponent& radar) :
+	Component(radar),
+	m_lastScanTime(0),
+	m_detectionRadius(radar.m_detectionRadius),
+	m_isPassiveScanEnabled(radar.m_isPassiveScanEnabled)
+	{
+	}
+
+	inline void RadarComponent::EnablePassiveScan(bool enable)
+	{
+		m_isPassiveScanEnabled = enable;
+	}
+
+	inline std::vector<RadarComponent::Contact>& RadarComponent::GetContacts()
+	{
+		return m_contacts;
+	}
+
+	inline const std::vector<RadarComponent::Contact>& RadarComponent::GetContacts() const
+	{
+		return m_contacts;
+	}
+
+	inline float RadarComponent::GetDetectionRadius() const
+	{
+		return m_detectionRadius;
+	}
+
+	inline Nz::UInt64 RadarComponent::GetLastScanTime() const
+	{
+		return m_lastScanTime;
+	}
+
+	inline bool RadarComponent::IsPassiveScanEnabled() const
+	{
+		return m_isPassiveScanEnabled;
+	}
+
+	inline void RadarComponent::SetLastScanTime(Nz::UInt64 scanTime)
+	{
+		m_lastScanTime = scanTime;
+	}
+}
@@ -16,13 +16,16 @@
 #include <Server/Modules/RadarModule.hpp>
 #include <Server/Modules/WeaponModule.hpp>
 #include <Server/Store/ModuleStore.hpp>
+#include <algorithm>
 #include <iostream>
 
 namespace ewn
 {
 	ScriptComponent::ScriptComponent() :
 	m_lastMessageTime(0),
-	m_tickCounter(0.f)
+	m_tickCounter(0.f),
+	m_spaceshipDataRef(-1),
+	m_spaceshipRef(-1)
 	{
 		m_instance.SetMemoryLimit(1'000'000);
 		m_instance.SetTimeLimit(50);
@@ -57,8 +60,18 @@ namespace ewn
 		});
 		m_instance.SetGlobal("warn");
 
-		if (!m_instance.ExecuteFromFile("spacelib.lua"))
+		m_instance.PushFunction([](Nz::LuaState& state) -> int
+		{
+			state.Traceback(state.ToString(-1));
+			return 1;
+		});
+		m_errorHandlerRef = m_instance.CreateReference();
+
+		assert(!s_libraryBytecode.empty() && "Library has not been precompiled");
+		if (!m_instance.ExecuteFromMemory(s_libraryBytecode.data(), s_libraryBytecode.size()))
 			assert(!"Failed to load spacelib.lua");
+
+		ResetStats();
 	}
 
 	ScriptComponent::ScriptComponent(const ScriptComponent& component) :
@@ -74,6 +87,12 @@ namespace ewn
 
 	bool ScriptComponent::Execute(Nz::String script, Nz::String* lastError)
 	{
+		// Script may (re)define callbacks, resolve them again on next call
+		Nz::CallOnExit invalidateHooks([&]()
+		{
+			m_callbackHooks.Invalidate(m_instance);
+		});
+
 		if (!m_instance.Execute(script))
 		{
 			if (lastError)
@@ -114,18 +133,98 @@ namespace ewn
 		}
 		m_instance.SetGlobal("ModuleType");
 
-		// Spaceship global table
+		// Spaceship global table, actual fields live in a data table so every assignment goes through __newindex (where cached callbacks get invalidated)
 		m_instance.PushTable();
 		{
 			m_core->Register(m_instance);
 		}
+		m_spaceshipDataRef = m_instance.CreateReference();
+
+		m_instance.PushTable();
+		m_instance.PushTable(0, 3);
+		{
+			m_instance.PushReference(m_spaceshipDataRef);
+			m_instance.SetField("__index");
+
+			m_instance.PushFunction([this](Nz::LuaState& state) -> int
+			{
+				// Spaceship, key, value
+				state.PushReference(m_spaceshipDataRef);
+				state.PushValue(2);
+				state.PushValue(3);
+				state.SetTable();
+
+				if (state.GetType(2) == Nz::LuaType_String)
+				{
+					const char* key = state.ToString(2);
+					for (SpaceshipCore::CallbackId callbackId = 0; callbackId < SpaceshipCore::CallbackCount; ++callbackId)
+					{
+						if (SpaceshipCore::GetCallbackName(callbackId) == key)
+						{
+							m_callbackHooks.Invalidate(state, callbackId);
+							break;
+						}
+					}
+				}
+
+				return 0;
+			});
+			m_instance.SetField("__newindex");
+
+			m_instance.PushFunction([this](Nz::LuaState& state) -> int
+			{
+				state.GetGlobal("next");
+				state.PushReference(m_spaceshipDataRef);
+				state.PushNil();
+				return 3;
+			});
+			m_instance.SetField("__pairs");
+		}
+		m_instance.SetMetatable(-2);
+
+		m_instance.PushValue(-1);
 		m_instance.SetGlobal("Spaceship");
 
-		m_core->PushCallback(0, "OnStart");
+		// Keep a reference to pass it to callbacks without looking it up
+		m_spaceshipRef = m_instance.CreateReference();
+
+		m_core->PushCallback(0, SpaceshipCore::OnStartCallback);
 
 		return true;
 	}
 
+	bool ScriptComponent::PrecompileLibrary(const Nz::String& filePath)
+	{
+		// Every bot loads the library, compile it once and let them load the resulting bytecode instead of reading and parsing the file
+		Nz::LuaInstance compiler;
+		compiler.LoadLibraries(Nz::LuaLib_String);
+
+		compiler.PushString(filePath);
+		compiler.SetGlobal("libraryPath");
+
+		if (!compiler.Execute("libraryBytecode = string.dump(assert(loadfile(libraryPath)))"))
+		{
+			std::cerr << "Failed to compile " << filePath << ": " << compiler.GetLastError() << std::endl;
+			return false;
+		}
+
+		compiler.GetGlobal("libraryBytecode");
+
+		std::size_t bytecodeSize;
+		const char* bytecode = compiler.ToString(-1, &bytecodeSize);
+		s_libraryBytecode.assign(bytecode, bytecodeSize);
+
+		compiler.Pop();
+
+		return true;
+	}
+
+	void ScriptComponent::ProcessCommands()
+	{
+		if (m_core)
+			m_core->ProcessCommands();
+	}
+
 	bool ScriptComponent::Run(ServerApplication* app, float elapsedTime, Nz::String* lastError)
 	{
 		assert(m_core);
@@ -135,8 +234,8 @@ namespace ewn
 
 		m_core->Run(elapsedTime);
 
-		std::string callbackName;
-		SpaceshipCore::CallbackArgFunction argFunction;
+		SpaceshipCore::CallbackId callbackId;
+		SpaceshipCore::CallbackArgs callbackArgs;
 
 		Nz::CallOnExit incrementTickCount([&]()
 		{
@@ -145,12 +244,8 @@ namespace ewn
 
 		if (m_tickCounter >= 0.5f)
 		{
-			callbackName = "OnTick";
-			argFunction = [](Nz::LuaState& state)
-			{
-				state.Push(0.5f);
-				return 1;
-			};
+			callbackId = SpaceshipCore::OnTickCallback;
+			callbackArgs = 0.5f;
 
 			m_tickCounter -= 0.5f;
 		}
@@ -160,54 +255,68 @@ namespace ewn
 			if (!callback)
 				return true;
 
-			callbackName = std::move(callback->first);
-			argFunction = std::move(callback->second);
+			callbackId = callback->first;
+			callbackArgs = std::move(callback->second);
 		}
 
 		incrementTickCount.CallAndReset();
 
-		m_instance.PushFunction([](Nz::LuaState& state) -> int
-		{
-			state.Traceback(state.ToString(-1));
-			return 1;
-		});
+		m_instance.PushReference(m_errorHandlerRef);
 
-		unsigned int popCount = 1;
 		Nz::CallOnExit popLuaStack([&]()
 		{
-			m_instance.Pop(popCount);
+			m_instance.Pop();
 		});
 
 		unsigned int errorHandler = m_instance.GetStackTop();
 
-		if (m_instance.GetGlobal("Spaceship") == Nz::LuaType_Table)
+		bool hasCallback = m_callbackHooks.Push(m_instance, callbackId, [&](Nz::LuaState& state)
 		{
-			popCount++;
+			state.PushReference(m_spaceshipRef);
+			Nz::LuaType callbackType = state.GetField(SpaceshipCore::GetCallbackName(callbackId));
+			state.Remove(-2);
 
-			if (m_instance.GetField(callbackName) == Nz::LuaType_Function)
-			{
-				m_instance.PushValue(-2); // Spaceship
+			return callbackType;
+		});
 
-				unsigned int argCount = 1;
-				if (argFunction)
-					argCount += argFunction(m_instance);
+		if (!hasCallback)
+			return true;
 
-				if (!m_instance.CallWithHandler(argCount, 0, errorHandler))
-				{
-					if (lastError)
-						*lastError = m_instance.GetLastError();
+		m_instance.PushReference(m_spaceshipRef);
 
-					m_script = Nz::String();
-					return false;
-				}
-			}
-			else
-				popCount++;
+		unsigned int argCount = 1 + SpaceshipCore::PushCallbackArgs(m_instance, callbackArgs);
+
+		Nz::UInt64 callbackStart = Nz::GetElapsedMicroseconds();
+		bool succeeded = m_instance.CallWithHandler(argCount, 0, errorHandler);
+		Nz::UInt64 callbackTime = Nz::GetElapsedMicroseconds() - callbackStart;
+
+		m_stats.callbackCount++;
+		m_stats.callbackTime += callbackTime;
+		m_stats.maxCallbackTime = std::max(m_stats.maxCallbackTime, callbackTime);
+		m_stats.memoryUsage = m_instance.GetMemoryUsage();
+		m_stats.peakMemoryUsage = std::max(m_stats.peakMemoryUsage, m_stats.memoryUsage);
+
+		if (!succeeded)
+		{
+			if (lastError)
+				*lastError = m_instance.GetLastError();
+
+			m_script = Nz::String();
+			return false;
 		}
 
 		return true;
 	}
 
+	void ScriptComponent::ResetStats()
+	{
+		m_stats.callbackCount = 0;
+		m_stats.callbackTime = 0;
+		m_stats.maxCallbackTime = 0;
+		m_stats.memoryUsage = m_instance.GetMemoryUsage();
+		m_stats.peakMemoryUsage = m_stats.memoryUsage;
+	}
+
 	void ScriptComponent::SendMessage(BotMessageType messageType, Nz::String message)
 	{
 		Nz::UInt64 now = Nz::GetElapsedMilliseconds();
@@ -243,4 +352,5 @@ namespace ewn
 	}
 
 	Ndk::ComponentIndex ScriptComponent::componentIndex;
+	std::string ScriptComponent::s_libraryBytecode;
 }
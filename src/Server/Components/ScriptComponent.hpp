@@ -12,7 +12,9 @@
 #include <NDK/EntityList.hpp>
 #include <Shared/Enums.hpp>
 #include <Server/SpaceshipCore.hpp>
+#include <Server/Scripting/LuaHookRegistry.hpp>
 #include <optional>
+#include <string>
 
 namespace ewn
 {
@@ -21,19 +23,36 @@ namespace ewn
 	class ScriptComponent : public Ndk::Component<ScriptComponent>
 	{
 		public:
+			struct Stats
+			{
+				Nz::UInt64 callbackCount;
+				Nz::UInt64 callbackTime;    //< in microseconds
+				Nz::UInt64 maxCallbackTime; //< in microseconds
+				std::size_t memoryUsage;
+				std::size_t peakMemoryUsage;
+			};
+
 			ScriptComponent();
 			ScriptComponent(const ScriptComponent& component);
 
 			bool Execute(Nz::String script, Nz::String* lastError);
 
+			inline const Stats& GetStats() const;
+
 			bool Initialize(ServerApplication* app, const std::vector<std::size_t>& moduleIds);
 
 			inline bool HasValidScript() const;
 
+			void ProcessCommands();
+
+			void ResetStats();
+
 			bool Run(ServerApplication* app, float elapsedTime, Nz::String* lastError = nullptr);
 
 			void SendMessage(BotMessageType messageType, Nz::String message);
 
+			static bool PrecompileLibrary(const Nz::String& filePath);
+
 			static Ndk::ComponentIndex componentIndex;
 
 		private:
@@ -43,7 +62,14 @@ namespace ewn
 			Nz::UInt64 m_lastMessageTime;
 			Nz::LuaInstance m_instance;
 			Nz::String m_script;
+			LuaHookRegistry m_callbackHooks;
+			Stats m_stats;
 			float m_tickCounter;
+			int m_errorHandlerRef;
+			int m_spaceshipDataRef; //< -1 (nil) until initialized
+			int m_spaceshipRef; //< -1 (nil) until initialized
+
+			static std::string s_libraryBytecode;
 	};
 }
 
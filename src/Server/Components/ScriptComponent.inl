@@ -6,6 +6,11 @@
 
 namespace ewn
 {
+	inline const ScriptComponent::Stats& ScriptComponent::GetStats() const
+	{
+		return m_stats;
+	}
+
 	inline bool ewn::ScriptComponent::HasValidScript() const
 	{
 		return !m_script.IsEmpty();
@@ -15,28 +15,22 @@ namespace ewn
 	class SynchronizedComponent : public Ndk::Component<SynchronizedComponent>
 	{
 		public:
-			inline SynchronizedComponent(std::size_t prefabId, std::string type, std::string nameTemp, bool movable, Nz::UInt16 networkPriority);
-
-			inline void AccumulatePriority();
+			inline SynchronizedComponent(std::size_t prefabId, Nz::UInt32 archetypeId, std::string name, bool movable, Nz::UInt16 networkPriority);
 
+			inline Nz::UInt32 GetArchetypeId() const;
 			inline const std::string& GetName() const;
 			inline std::size_t GetPrefabId() const;
 			inline Nz::UInt16 GetPriority() const;
-			inline Nz::UInt16 GetPriorityAccumulator() const;
-			inline const std::string& GetType() const;
 
 			inline bool IsMovable() const;
 
-			inline void ResetPriorityAccumulator();
-
 			static Ndk::ComponentIndex componentIndex;
 
 		private:
 			std::size_t m_prefabId;
 			std::string m_name;
-			std::string m_type;
+			Nz::UInt32 m_archetypeId;
 			Nz::UInt16 m_priority;
-			Nz::UInt16 m_priorityAccumulator;
 			bool m_movable;
 	};
 }
@@ -7,23 +7,18 @@
 
 namespace ewn
 {
-	inline SynchronizedComponent::SynchronizedComponent(std::size_t prefabId, std::string type, std::string nameTemp, bool movable, Nz::UInt16 networkPriority) :
+	inline SynchronizedComponent::SynchronizedComponent(std::size_t prefabId, Nz::UInt32 archetypeId, std::string name, bool movable, Nz::UInt16 networkPriority) :
 	m_prefabId(prefabId),
-	m_name(std::move(nameTemp)),
-	m_type(std::move(type)),
+	m_name(std::move(name)),
+	m_archetypeId(archetypeId),
 	m_priority(networkPriority),
-	m_priorityAccumulator(networkPriority),
 	m_movable(movable)
 	{
 	}
 
-	inline void SynchronizedComponent::AccumulatePriority()
+	inline Nz::UInt32 SynchronizedComponent::GetArchetypeId() const
 	{
-		Nz::UInt16 newPriority = m_priorityAccumulator + m_priority;
-		if (newPriority < m_priorityAccumulator) // Overflow protection
-			m_priorityAccumulator = std::numeric_limits<decltype(m_priorityAccumulator)>::max();
-		else
-			m_priorityAccumulator = newPriority;
+		return m_archetypeId;
 	}
 
 	inline const std::string& SynchronizedComponent::GetName() const
@@ -41,23 +36,8 @@ namespace ewn
 		return m_priority;
 	}
 
-	inline Nz::UInt16 SynchronizedComponent::GetPriorityAccumulator() const
-	{
-		return m_priorityAccumulator;
-	}
-
-	inline const std::string& SynchronizedComponent::GetType() const
-	{
-		return m_type;
-	}
-
 	inline bool SynchronizedComponent::IsMovable() const
 	{
 		return m_movable;
 	}
-
-	inline void SynchronizedComponent::ResetPriorityAccumulator()
-	{
-		m_priorityAccumulator = 0;
-	}
 }
@@ -4,12 +4,14 @@
 
 #include <Server/Modules/CommunicationsModule.hpp>
 #include <Nazara/Core/MemoryHelper.hpp>
-#include <Nazara/Physics3D/PhysWorld3D.hpp>
 #include <NDK/LuaAPI.hpp>
 #include <NDK/World.hpp>
-#include <NDK/Systems/PhysicsSystem3D.hpp>
+#include <NDK/Components/NodeComponent.hpp>
+#include <Server/ServerApplication.hpp>
 #include <Server/Scripting/LuaMathTypes.hpp>
 #include <Server/Components/CommunicationComponent.hpp>
+#include <Server/Systems/BroadphaseSystem.hpp>
+#include <algorithm>
 #include <cmath>
 
 namespace ewn
@@ -29,81 +31,73 @@ namespace ewn
 
 	void CommunicationsModule::BroadcastCone(const Nz::Vector3f& direction, float distance, const std::string& message)
 	{
-		const Ndk::EntityHandle& spaceship = GetSpaceship();
-		auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
+		if (!ClampRange(distance))
+			return;
 
-		float coneBaseRadius = std::tan(Nz::DegreeToRadian(30.f)) * distance;
-
-		Nz::Vector3f position = spaceshipNode.GetPosition();
-		Nz::Boxf detectionBox = Nz::Boxf(spaceshipNode.GetPosition() + spaceshipNode.GetLeft() * coneBaseRadius + spaceshipNode.GetUp() * coneBaseRadius, spaceshipNode.GetPosition() + spaceshipNode.GetForward() * distance + spaceshipNode.GetRight() * coneBaseRadius + spaceshipNode.GetDown() * coneBaseRadius);
-
-		Ndk::World* world = spaceship->GetWorld();
-		Nz::PhysWorld3D& physWorld = world->GetSystem<Ndk::PhysicsSystem3D>().GetWorld();
-		physWorld.ForEachBodyInAABB(detectionBox, [&](Nz::RigidBody3D& body)
+		// Delivering messages touches other spaceships modules, wait for the script system to apply it
+		GetCore()->PostCommand([this, direction, distance, message]()
 		{
-			Nz::Vector3f bodyPosition = body.GetPosition();
-			//TODO: Check for cone
-			if (/*cone check*/ true)
+			const Ndk::EntityHandle& spaceship = GetSpaceship();
+			auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
+
+			Ndk::World* world = spaceship->GetWorld();
+			world->GetSystem<BroadphaseSystem>().ForEachInCone(spaceshipNode.GetPosition(), Nz::Vector3f::Normalize(direction), distance, Nz::DegreeToRadian(30.f), [&](const BroadphaseSystem::EntityData& entityData)
 			{
-				Ndk::EntityId bodyId = static_cast<Ndk::EntityId>(reinterpret_cast<std::ptrdiff_t>(body.GetUserdata()));
-				if (bodyId != spaceship->GetId())
+				if (entityData.id != spaceship->GetId())
 				{
-					const Ndk::EntityHandle& bodyEntity = world->GetEntity(bodyId);
+					const Ndk::EntityHandle& bodyEntity = world->GetEntity(entityData.id);
 					if (bodyEntity->HasComponent<CommunicationComponent>())
 						bodyEntity->GetComponent<CommunicationComponent>().SendMessage(spaceship, message);
 				}
-			}
-
-			return true;
+			});
 		});
 	}
 
 	void CommunicationsModule::BroadcastSphere(float distance, const std::string& message)
 	{
-		const Ndk::EntityHandle& spaceship = GetSpaceship();
-		auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
+		if (!ClampRange(distance))
+			return;
 
-		Nz::Vector3f position = spaceshipNode.GetPosition();
-		Nz::Boxf detectionBox = Nz::Boxf(position - Nz::Vector3f(distance), position + Nz::Vector3f(distance));
-
-		Ndk::World* world = spaceship->GetWorld();
-		Nz::PhysWorld3D& physWorld = world->GetSystem<Ndk::PhysicsSystem3D>().GetWorld();
-		float maxSquaredRadius = distance * distance;
-		physWorld.ForEachBodyInAABB(detectionBox, [&](Nz::RigidBody3D& body)
+		GetCore()->PostCommand([this, distance, message]()
 		{
-			Nz::Vector3f bodyPosition = body.GetPosition();
-			if (bodyPosition.SquaredDistance(position) < maxSquaredRadius)
+			const Ndk::EntityHandle& spaceship = GetSpaceship();
+			auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
+
+			Ndk::World* world = spaceship->GetWorld();
+			world->GetSystem<BroadphaseSystem>().ForEachInSphere(spaceshipNode.GetPosition(), distance, [&](const BroadphaseSystem::EntityData& entityData)
 			{
-				Ndk::EntityId bodyId = static_cast<Ndk::EntityId>(reinterpret_cast<std::ptrdiff_t>(body.GetUserdata()));
-				if (bodyId != spaceship->GetId())
+				if (entityData.id != spaceship->GetId())
 				{
-					const Ndk::EntityHandle& bodyEntity = world->GetEntity(bodyId);
+					const Ndk::EntityHandle& bodyEntity = world->GetEntity(entityData.id);
 					if (bodyEntity->HasComponent<CommunicationComponent>())
 						bodyEntity->GetComponent<CommunicationComponent>().SendMessage(spaceship, message);
 				}
-			}
-
-			return true;
+			});
 		});
 	}
 
-	void CommunicationsModule::RegisterModule(Nz::LuaClass<SpaceshipModule>& parentBinding, Nz::LuaState& lua)
+	void CommunicationsModule::BindModule(Nz::LuaClass<SpaceshipModule>& parentBinding)
 	{
-		if (!s_binding)
+		s_binding.emplace("Communications");
+		s_binding->Inherit<SpaceshipModule>(parentBinding, [](CommunicationsModuleHandle* moduleRef) -> SpaceshipModule*
 		{
-			s_binding.emplace("Communications");
-			s_binding->Inherit<SpaceshipModule>(parentBinding, [](CommunicationsModuleHandle* moduleRef) -> SpaceshipModule*
-			{
-				return moduleRef->GetObject();
-			});
+			return moduleRef->GetObject();
+		});
 
-			s_binding->BindMethod("BroadcastCone",   &CommunicationsModule::BroadcastCone);
-			s_binding->BindMethod("BroadcastSphere", &CommunicationsModule::BroadcastSphere);
-		}
+		s_binding->BindMethod("BroadcastCone",   &CommunicationsModule::BroadcastCone);
+		s_binding->BindMethod("BroadcastSphere", &CommunicationsModule::BroadcastSphere);
+	}
 
+	void CommunicationsModule::RegisterModule(Nz::LuaState& lua)
+	{
 		s_binding->Register(lua);
 	}
 
+	void CommunicationsModule::UnbindModule()
+	{
+		s_binding.reset();
+	}
+
 	void CommunicationsModule::Run(float elapsedTime)
 	{
 		m_callbackCounter += elapsedTime;
@@ -116,7 +110,7 @@ namespace ewn
 				const Ndk::EntityHandle& spaceship = GetSpaceship();
 				auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
 
-				PushCallback("OnCommunicationReceivedMessages", [messages = m_pendingMessages, position = spaceshipNode.GetPosition()](Nz::LuaState& state)
+				PushCallback(SpaceshipCore::OnCommunicationReceivedMessagesCallback, [messages = m_pendingMessages, position = spaceshipNode.GetPosition()](Nz::LuaState& state)
 				{
 					state.PushTable(messages.size());
 
@@ -146,6 +140,17 @@ namespace ewn
 		}
 	}
 
+	bool CommunicationsModule::ClampRange(float& distance)
+	{
+		// Distance comes straight from bot scripts
+		if (!std::isfinite(distance) || distance < 0.f)
+			return false;
+
+		float maxRange = GetCore()->GetApp()->GetConfig().GetFloatOption<float>("Game.MaxCommunicationRange");
+		distance = std::min(distance, maxRange);
+		return true;
+	}
+
 	void CommunicationsModule::OnReceivedMessage(CommunicationComponent*, const Ndk::EntityHandle& emitter, const std::string& message)
 	{
 		Nz::Vector3f emitterPos = emitter->GetComponent<Ndk::NodeComponent>().GetPosition();
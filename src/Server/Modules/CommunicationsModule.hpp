@@ -30,15 +30,19 @@ namespace ewn
 
 			void PushInstance(Nz::LuaState& lua) override;
 
-			void RegisterModule(Nz::LuaClass<SpaceshipModule>& parentBinding, Nz::LuaState& lua) override;
+			void RegisterModule(Nz::LuaState& lua) override;
 			void Run(float elapsedTime) override;
 
+			static void BindModule(Nz::LuaClass<SpaceshipModule>& parentBinding);
+			static void UnbindModule();
+
 			// Lua API
 			void BroadcastCone(const Nz::Vector3f& direction, float distance, const std::string& message);
 			void BroadcastSphere(float distance, const std::string& message);
 
 
 		private:
+			bool ClampRange(float& distance);
 			void OnReceivedMessage(CommunicationComponent* /*communication*/, const Ndk::EntityHandle& emitter, const std::string& message);
 
 			NazaraSlot(CommunicationComponent, OnReceivedMessage, m_onReceivedMessageSlot);
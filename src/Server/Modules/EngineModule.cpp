@@ -15,8 +15,13 @@ namespace ewn
 		impulse.y = Nz::Clamp(impulse.y, -1.f, 1.f);
 		impulse.z = Nz::Clamp(impulse.z, -1.f, 1.f);
 
-		NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
-		spaceshipNavigation.AddImpulse(impulse, GetCore()->GetApp()->GetAppTime() + Nz::UInt64(duration * 1'000));
+		Nz::UInt64 expirationTime = GetCore()->GetApp()->GetAppTime() + Nz::UInt64(duration * 1'000);
+
+		GetCore()->PostCommand([this, impulse, expirationTime]()
+		{
+			NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
+			spaceshipNavigation.AddImpulse(impulse, expirationTime);
+		});
 	}
 
 	void EngineModule::PushInstance(Nz::LuaState& lua)
@@ -24,21 +29,26 @@ namespace ewn
 		lua.Push(this);
 	}
 
-	void EngineModule::RegisterModule(Nz::LuaClass<SpaceshipModule>& parentBinding, Nz::LuaState& lua)
+	void EngineModule::BindModule(Nz::LuaClass<SpaceshipModule>& parentBinding)
 	{
-		if (!s_binding)
+		s_binding.emplace("Engine");
+		s_binding->Inherit<SpaceshipModule>(parentBinding, [](EngineModuleHandle* moduleRef) -> SpaceshipModule*
 		{
-			s_binding.emplace("Engine");
-			s_binding->Inherit<SpaceshipModule>(parentBinding, [](EngineModuleHandle* moduleRef) -> SpaceshipModule*
-			{
-				return moduleRef->GetObject();
-			});
+			return moduleRef->GetObject();
+		});
 
-			s_binding->BindMethod("Impulse", &EngineModule::Impulse);
-		}
+		s_binding->BindMethod("Impulse", &EngineModule::Impulse);
+	}
 
+	void EngineModule::RegisterModule(Nz::LuaState& lua)
+	{
 		s_binding->Register(lua);
 	}
 
+	void EngineModule::UnbindModule()
+	{
+		s_binding.reset();
+	}
+
 	std::optional<Nz::LuaClass<EngineModuleHandle>> EngineModule::s_binding;
 }
@@ -26,7 +26,10 @@ namespace ewn
 			~EngineModule() = default;
 
 			void PushInstance(Nz::LuaState& lua) override;
-			void RegisterModule(Nz::LuaClass<SpaceshipModule>& parentBinding, Nz::LuaState& lua) override;
+			void RegisterModule(Nz::LuaState& lua) override;
+
+			static void BindModule(Nz::LuaClass<SpaceshipModule>& parentBinding);
+			static void UnbindModule();
 
 			// Lua API
 			void Impulse(Nz::Vector3f impulse, float duration);
@@ -20,153 +20,180 @@ namespace ewn
 		lua.Push(this);
 	}
 	
-	void NavigationModule::RegisterModule(Nz::LuaClass<SpaceshipModule>& parentBinding, Nz::LuaState& lua)
+	void NavigationModule::BindModule(Nz::LuaClass<SpaceshipModule>& parentBinding)
 	{
-		if (!s_binding)
+		s_binding.emplace("Navigation");
+		s_binding->Inherit<SpaceshipModule>(parentBinding, [](NavigationModuleHandle* moduleRef) -> SpaceshipModule*
 		{
-			s_binding.emplace("Navigation");
-			s_binding->Inherit<SpaceshipModule>(parentBinding, [](NavigationModuleHandle* moduleRef) -> SpaceshipModule*
-			{
-				return moduleRef->GetObject();
-			});
+			return moduleRef->GetObject();
+		});
 
-			s_binding->BindMethod("FollowTarget", [](Nz::LuaState& state, NavigationModule* navigation, std::size_t argCount)
+		s_binding->BindMethod("FollowTarget", [](Nz::LuaState& state, NavigationModule* navigation, std::size_t argCount)
+		{
+			int argIndex = 2;
+			switch (argCount)
 			{
-				int argIndex = 2;
-				switch (argCount)
+				case 0:
+				case 1:
 				{
-					case 0:
-					case 1:
-					{
-						Nz::Int64 signature = state.Check<Nz::Int64>(&argIndex);
-						navigation->FollowTarget(signature);
-						break;
-					}
-
-					case 2:
-					default:
-					{
-						Nz::Int64 signature = state.Check<Nz::Int64>(&argIndex);
-						float triggerDistance = state.Check<float>(&argIndex);
-						navigation->FollowTarget(signature, triggerDistance);
-						break;
-					}
+					Nz::Int64 signature = state.Check<Nz::Int64>(&argIndex);
+					navigation->FollowTarget(signature);
+					break;
 				}
 
-				return 0;
-			});
+				case 2:
+				default:
+				{
+					Nz::Int64 signature = state.Check<Nz::Int64>(&argIndex);
+					float triggerDistance = state.Check<float>(&argIndex);
+					navigation->FollowTarget(signature, triggerDistance);
+					break;
+				}
+			}
 
-			s_binding->BindMethod("MoveToPosition", [](Nz::LuaState& state, NavigationModule* navigation, std::size_t argCount)
+			return 0;
+		});
+
+		s_binding->BindMethod("MoveToPosition", [](Nz::LuaState& state, NavigationModule* navigation, std::size_t argCount)
+		{
+			int argIndex = 2;
+			switch (argCount)
 			{
-				int argIndex = 2;
-				switch (argCount)
+				case 0:
+				case 1:
 				{
-					case 0:
-					case 1:
-					{
-						Nz::Vector3f targetPos = state.Check<Nz::Vector3f>(&argIndex);
-						navigation->MoveToPosition(targetPos);
-						break;
-					}
-
-					case 2:
-					default:
-					{
-						Nz::Vector3f targetPos = state.Check<Nz::Vector3f>(&argIndex);
-						float triggerDistance = state.Check<float>(&argIndex);
-						navigation->MoveToPosition(targetPos, triggerDistance);
-						break;
-					}
+					Nz::Vector3f targetPos = state.Check<Nz::Vector3f>(&argIndex);
+					navigation->MoveToPosition(targetPos);
+					break;
 				}
 
-				return 0;
-			});
+				case 2:
+				default:
+				{
+					Nz::Vector3f targetPos = state.Check<Nz::Vector3f>(&argIndex);
+					float triggerDistance = state.Check<float>(&argIndex);
+					navigation->MoveToPosition(targetPos, triggerDistance);
+					break;
+				}
+			}
 
-			s_binding->BindMethod("OrientToPosition", &NavigationModule::OrientToPosition);
-			s_binding->BindMethod("OrientToTarget", &NavigationModule::OrientToTarget);
+			return 0;
+		});
+
+		s_binding->BindMethod("OrientToPosition", &NavigationModule::OrientToPosition);
+		s_binding->BindMethod("OrientToTarget", &NavigationModule::OrientToTarget);
 
-			s_binding->BindMethod("Stop", &NavigationModule::Stop);
-		}
+		s_binding->BindMethod("Stop", &NavigationModule::Stop);
+	}
 
+	void NavigationModule::RegisterModule(Nz::LuaState& lua)
+	{
 		s_binding->Register(lua);
 	}
 
+	void NavigationModule::UnbindModule()
+	{
+		s_binding.reset();
+	}
+
 	void NavigationModule::FollowTarget(Nz::Int64 targetSignature)
 	{
-		RadarModule* radarModule = GetCore()->GetModule<RadarModule>(ModuleType::Radar);
-		if (!radarModule)
-			return;
-
-		const Ndk::EntityHandle& spaceship = GetSpaceship();
-		NavigationComponent& spaceshipNavigation = spaceship->GetComponent<NavigationComponent>();
-		if (const Ndk::EntityHandle& target = radarModule->FindEntityBySignature(targetSignature))
-			spaceshipNavigation.SetTarget(target);
-		else
-			spaceshipNavigation.ClearTarget();
+		// Targets are held through entity handles, which cannot be copied while scripts are running in parallel
+		GetCore()->PostCommand([this, targetSignature]()
+		{
+			RadarModule* radarModule = GetCore()->GetModule<RadarModule>(ModuleType::Radar);
+			if (!radarModule)
+				return;
+
+			const Ndk::EntityHandle& spaceship = GetSpaceship();
+			NavigationComponent& spaceshipNavigation = spaceship->GetComponent<NavigationComponent>();
+			if (const Ndk::EntityHandle& target = radarModule->FindEntityBySignature(targetSignature))
+				spaceshipNavigation.SetTarget(target);
+			else
+				spaceshipNavigation.ClearTarget();
+		});
 	}
 
 	void NavigationModule::FollowTarget(Nz::Int64 targetSignature, float triggerDistance)
 	{
-		RadarModule* radarModule = GetCore()->GetModule<RadarModule>(ModuleType::Radar);
-		if (!radarModule)
-			return;
-
-		const Ndk::EntityHandle& spaceship = GetSpaceship();
-		NavigationComponent& spaceshipNavigation = spaceship->GetComponent<NavigationComponent>();
-		if (const Ndk::EntityHandle& target = radarModule->FindEntityBySignature(targetSignature))
+		GetCore()->PostCommand([this, targetSignature, triggerDistance]()
 		{
-			spaceshipNavigation.SetTarget(target, triggerDistance, [moduleHandle = CreateHandle()]()
-			{
-				if (!moduleHandle)
-					return;
+			RadarModule* radarModule = GetCore()->GetModule<RadarModule>(ModuleType::Radar);
+			if (!radarModule)
+				return;
 
-				moduleHandle->PushCallback("OnNavigationDestinationReached");
-			});
-		}
-		else
-			spaceshipNavigation.ClearTarget();
+			const Ndk::EntityHandle& spaceship = GetSpaceship();
+			NavigationComponent& spaceshipNavigation = spaceship->GetComponent<NavigationComponent>();
+			if (const Ndk::EntityHandle& target = radarModule->FindEntityBySignature(targetSignature))
+			{
+				spaceshipNavigation.SetTarget(target, triggerDistance, [moduleHandle = CreateHandle()]()
+				{
+					if (!moduleHandle)
+						return;
+
+					moduleHandle->PushCallback(SpaceshipCore::OnNavigationDestinationReachedCallback);
+				});
+			}
+			else
+				spaceshipNavigation.ClearTarget();
+		});
 	}
 
 	void NavigationModule::MoveToPosition(const Nz::Vector3f& targetPos)
 	{
-		NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
-		spaceshipNavigation.SetTarget(targetPos);
+		GetCore()->PostCommand([this, targetPos]()
+		{
+			NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
+			spaceshipNavigation.SetTarget(targetPos);
+		});
 	}
 
 	void NavigationModule::MoveToPosition(const Nz::Vector3f& targetPos, float triggerDistance)
 	{
-		NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
-		spaceshipNavigation.SetTarget(targetPos, triggerDistance, [moduleHandle = CreateHandle()]()
+		GetCore()->PostCommand([this, targetPos, triggerDistance]()
 		{
-			if (!moduleHandle)
-				return;
+			NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
+			spaceshipNavigation.SetTarget(targetPos, triggerDistance, [moduleHandle = CreateHandle()]()
+			{
+				if (!moduleHandle)
+					return;
 
-			moduleHandle->PushCallback("OnNavigationDestinationReached");
+				moduleHandle->PushCallback(SpaceshipCore::OnNavigationDestinationReachedCallback);
+			});
 		});
 	}
 
 	void NavigationModule::OrientToPosition(const Nz::Vector3f & targetPos)
 	{
-		NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
-		spaceshipNavigation.SetTarget(targetPos, false);
+		GetCore()->PostCommand([this, targetPos]()
+		{
+			NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
+			spaceshipNavigation.SetTarget(targetPos, false);
+		});
 	}
 
 	void NavigationModule::OrientToTarget(Nz::Int64 targetSignature)
 	{
-		RadarModule* radarModule = GetCore()->GetModule<RadarModule>(ModuleType::Radar);
-		if (!radarModule)
-			return;
-
-		const Ndk::EntityHandle& spaceship = GetSpaceship();
-		NavigationComponent& spaceshipNavigation = spaceship->GetComponent<NavigationComponent>();
-		if (const Ndk::EntityHandle& target = radarModule->FindEntityBySignature(targetSignature))
-			spaceshipNavigation.SetTarget(target, false);
+		GetCore()->PostCommand([this, targetSignature]()
+		{
+			RadarModule* radarModule = GetCore()->GetModule<RadarModule>(ModuleType::Radar);
+			if (!radarModule)
+				return;
+
+			const Ndk::EntityHandle& spaceship = GetSpaceship();
+			NavigationComponent& spaceshipNavigation = spaceship->GetComponent<NavigationComponent>();
+			if (const Ndk::EntityHandle& target = radarModule->FindEntityBySignature(targetSignature))
+				spaceshipNavigation.SetTarget(target, false);
+		});
 	}
 
 	void NavigationModule::Stop()
 	{
-		NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
-		spaceshipNavigation.ClearTarget();
+		GetCore()->PostCommand([this]()
+		{
+			NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
+			spaceshipNavigation.ClearTarget();
+		});
 	}
 
 	std::optional<Nz::LuaClass<NavigationModuleHandle>> NavigationModule::s_binding;
@@ -25,7 +25,10 @@ namespace ewn
 			~NavigationModule() = default;
 
 			void PushInstance(Nz::LuaState& lua) override;
-			void RegisterModule(Nz::LuaClass<SpaceshipModule>& parentBinding, Nz::LuaState& lua) override;
+			void RegisterModule(Nz::LuaState& lua) override;
+
+			static void BindModule(Nz::LuaClass<SpaceshipModule>& parentBinding);
+			static void UnbindModule();
 
 			// Lua API
 			void FollowTarget(Nz::Int64 targetSignature);
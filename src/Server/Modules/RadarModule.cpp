@@ -5,167 +5,85 @@
 #include <Server/Modules/RadarModule.hpp>
 #include <Nazara/Core/Clock.hpp>
 #include <Nazara/Math/BoundingVolume.hpp>
-#include <Nazara/Physics3D/PhysWorld3D.hpp>
 #include <NDK/LuaAPI.hpp>
 #include <NDK/World.hpp>
 #include <NDK/Components/NodeComponent.hpp>
 #include <NDK/Components/PhysicsComponent3D.hpp>
-#include <NDK/Systems/PhysicsSystem3D.hpp>
 #include <Server/Components/SignatureComponent.hpp>
 #include <Server/Components/SynchronizedComponent.hpp>
 #include <Server/Scripting/LuaTypes.hpp>
+#include <Server/Systems/BroadphaseSystem.hpp>
 #include <iostream>
 
 namespace ewn
 {
-	
+	void RadarModule::Initialize(Ndk::Entity* spaceship)
+	{
+		if (!spaceship->HasComponent<RadarComponent>())
+			spaceship->AddComponent<RadarComponent>(m_detectionRadius);
+
+		m_onContactsUpdateSlot.Connect(spaceship->GetComponent<RadarComponent>().OnContactsUpdate, this, &RadarModule::OnContactsUpdate);
+	}
+
 	void RadarModule::PushInstance(Nz::LuaState& lua)
 	{
 		lua.Push(this);
 	}
 
-	void RadarModule::RegisterModule(Nz::LuaClass<SpaceshipModule>& parentBinding, Nz::LuaState& lua)
+	void RadarModule::BindModule(Nz::LuaClass<SpaceshipModule>& parentBinding)
 	{
-		if (!s_binding)
+		s_binding.emplace("Radar");
+		s_binding->Inherit<SpaceshipModule>(parentBinding, [](RadarModuleHandle* moduleRef) -> SpaceshipModule*
 		{
-			s_binding.emplace("Radar");
-			s_binding->Inherit<SpaceshipModule>(parentBinding, [](RadarModuleHandle* moduleRef) -> SpaceshipModule*
-			{
-				return moduleRef->GetObject();
-			});
-
-			s_binding->BindMethod("EnablePassiveScan", &RadarModule::EnablePassiveScan);
-			s_binding->BindMethod("GetTargetInfo", &RadarModule::GetTargetInfo);
-			s_binding->BindMethod("IsPassiveScanEnabled", &RadarModule::IsPassiveScanEnabled);
-			s_binding->BindMethod("Scan", &RadarModule::Scan);
-
-			// Workaround for value reply bug
-			s_binding->BindMethod("GetTargetInfo", [](Nz::LuaState& state, RadarModule* radar, std::size_t /*argCount*/)
-			{
-				int argIndex = 2;
-				decltype(auto) result = radar->GetTargetInfo(state.Check<Nz::Int64>(&argIndex));
-				if (result.has_value())
-					state.Push(*result);
-				else
-					state.PushNil();
-
-				return 1;
-			});
-
-			s_binding->BindMethod("Scan", [](Nz::LuaState& state, RadarModule* radar, std::size_t /*argCount*/)
-			{
-				int argIndex = 2;
-				std::vector<RangeInfo> result = radar->Scan();
-
-				state.PushTable(result.size(), 0);
-
-				std::size_t index = 1;
-				for (const RangeInfo& info : result)
-				{
-					state.Push(index++); // key
-					state.Push(info); // value
+			return moduleRef->GetObject();
+		});
 
-					state.SetTable();
-				}
+		s_binding->BindMethod("EnablePassiveScan", &RadarModule::EnablePassiveScan);
+		s_binding->BindMethod("GetTargetInfo", &RadarModule::GetTargetInfo);
+		s_binding->BindMethod("IsPassiveScanEnabled", &RadarModule::IsPassiveScanEnabled);
+		s_binding->BindMethod("Scan", &RadarModule::Scan);
 
-				return 1;
-			});
-		}
+		// Workaround for value reply bug
+		s_binding->BindMethod("GetTargetInfo", [](Nz::LuaState& state, RadarModule* radar, std::size_t /*argCount*/)
+		{
+			int argIndex = 2;
+			decltype(auto) result = radar->GetTargetInfo(state.Check<Nz::Int64>(&argIndex));
+			if (result.has_value())
+				state.Push(*result);
+			else
+				state.PushNil();
 
-		s_binding->Register(lua);
-	}
+			return 1;
+		});
 
-	void RadarModule::Run(float /*elapsedTime*/)
-	{
-		if (m_isPassiveScanEnabled)
+		s_binding->BindMethod("Scan", [](Nz::LuaState& state, RadarModule* radar, std::size_t /*argCount*/)
 		{
-			Nz::UInt64 now = GetCore()->GetApp()->GetAppTime();
-			if (now - m_lastPassiveScanTime > 500)
-			{
-				PerformScan();
-				m_lastPassiveScanTime = now;
-			}
-		}
-
-		const Ndk::EntityHandle& spaceship = GetSpaceship();
-		auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
+			int argIndex = 2;
+			std::vector<RangeInfo> result = radar->Scan();
 
-		Nz::Vector3f radarCenter = spaceshipNode.GetPosition();
+			state.PushTable(result.size(), 0);
 
-		float maxDetectionRadiusSq = m_detectionRadius * m_detectionRadius;
-		for (const Ndk::EntityHandle& target : m_entitiesInRadius)
-		{
-			auto& targetNode = target->GetComponent<Ndk::NodeComponent>();
-			if (targetNode.GetPosition().SquaredDistance(radarCenter) > maxDetectionRadiusSq)
+			std::size_t index = 1;
+			for (const RangeInfo& info : result)
 			{
-				m_entitiesInRadius.Remove(target);
+				state.Push(index++); // key
+				state.Push(info); // value
 
-				if (target->HasComponent<SignatureComponent>())
-				{
-					const SignatureComponent& component = target->GetComponent<SignatureComponent>();
-
-					m_signatureToEntity.erase(component.GetSignature());
-				}
+				state.SetTable();
 			}
-		}
+
+			return 1;
+		});
 	}
 
-	void RadarModule::PerformScan()
+	void RadarModule::RegisterModule(Nz::LuaState& lua)
 	{
-		const Ndk::EntityHandle& spaceship = GetSpaceship();
-		auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
-
-		Nz::Vector3f position = spaceshipNode.GetPosition();
-		Nz::Boxf detectionBox = Nz::Boxf(position - Nz::Vector3f(m_detectionRadius), position + Nz::Vector3f(m_detectionRadius));
-
-		Ndk::World* world = spaceship->GetWorld();
-		Nz::PhysWorld3D& physWorld = world->GetSystem<Ndk::PhysicsSystem3D>().GetWorld();
-		float maxSquaredRadius = m_detectionRadius * m_detectionRadius;
-		physWorld.ForEachBodyInAABB(detectionBox, [&](Nz::RigidBody3D& body)
-		{
-			Nz::Vector3f bodyPosition = body.GetPosition();
-			if (bodyPosition.SquaredDistance(position) < maxSquaredRadius)
-			{
-				Ndk::EntityId bodyId = static_cast<Ndk::EntityId>(reinterpret_cast<std::ptrdiff_t>(body.GetUserdata()));
-				if (!m_entitiesInRadius.Has(bodyId) && bodyId != spaceship->GetId())
-				{
-					const Ndk::EntityHandle& bodyEntity = world->GetEntity(bodyId);
-
-					m_entitiesInRadius.Insert(bodyEntity);
-
-					Nz::Int64 signature = bodyEntity->GetId(); //< Meh
-					double radius = -1.f;
-					double emSignature = 0.0;
-					if (bodyEntity->HasComponent<SignatureComponent>())
-					{
-						const SignatureComponent& component = bodyEntity->GetComponent<SignatureComponent>();
-						emSignature = component.GetEmSignature();
-						signature = component.GetSignature();
-						radius = component.GetSize();
-
-						m_signatureToEntity.insert_or_assign(signature, bodyEntity);
-					}
-
-					float distance;
-					Nz::Vector3f direction = bodyPosition - position;
-					direction.Normalize(&distance);
-
-					PushCallback("OnRadarNewObjectInRange", [signature, emSignature, radius, direction, distance](Nz::LuaState& state)
-					{
-						state.Push(signature);
-						state.Push(emSignature);
-						state.Push(radius);
-						state.Push(LuaVec3(direction));
-						state.Push(distance);
-
-						return 5;
-					},
-					false);
-				}
-			}
+		s_binding->Register(lua);
+	}
 
-			return true;
-		});
+	void RadarModule::UnbindModule()
+	{
+		s_binding.reset();
 	}
 
 	std::optional<RadarModule::TargetInfo> RadarModule::GetTargetInfo(Nz::Int64 signature)
@@ -177,7 +95,12 @@ namespace ewn
 		if (!m_entitiesInRadius.Has(target))
 		{
 			//TODO: Log?
-			m_signatureToEntity.erase(signature);
+
+			// Releasing the handle updates the target entity, don't do it while scripts are running in parallel
+			GetCore()->PostCommand([this, signature]()
+			{
+				m_signatureToEntity.erase(signature);
+			});
 			return {};
 		}
 
@@ -226,6 +149,38 @@ namespace ewn
 		return targetInfo;
 	}
 
+	void RadarModule::OnContactsUpdate(RadarComponent* /*radar*/, const Nz::Vector3f& radarPosition, const std::vector<const BroadphaseSystem::EntityData*>& newContacts, const std::vector<RadarComponent::Contact>& lostContacts)
+	{
+		for (const RadarComponent::Contact& contact : lostContacts)
+		{
+			m_entitiesInRadius.Remove(contact.entity);
+
+			if (contact.hasSignature)
+				m_signatureToEntity.erase(contact.signature);
+		}
+
+		Ndk::World* world = GetSpaceship()->GetWorld();
+		for (const BroadphaseSystem::EntityData* entityData : newContacts)
+		{
+			const Ndk::EntityHandle& bodyEntity = world->GetEntity(entityData->id);
+
+			m_entitiesInRadius.Insert(bodyEntity);
+
+			if (entityData->hasSignature)
+				m_signatureToEntity.insert_or_assign(entityData->signature, bodyEntity);
+
+			SpaceshipCore::RadarObjectArgs callbackArgs;
+			callbackArgs.signature = entityData->signature;
+			callbackArgs.emSignature = entityData->emSignature;
+			callbackArgs.radius = entityData->size;
+
+			callbackArgs.direction = entityData->position - radarPosition;
+			callbackArgs.direction.Normalize(&callbackArgs.distance);
+
+			PushCallback(SpaceshipCore::OnRadarNewObjectInRangeCallback, std::move(callbackArgs), false);
+		}
+	}
+
 	std::vector<RadarModule::RangeInfo> RadarModule::Scan()
 	{
 		const Ndk::EntityHandle& spaceship = GetSpaceship();
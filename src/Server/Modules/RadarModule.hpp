@@ -10,6 +10,7 @@
 #include <Nazara/Lua/LuaClass.hpp>
 #include <NDK/EntityList.hpp>
 #include <Server/SpaceshipModule.hpp>
+#include <Server/Components/RadarComponent.hpp>
 #include <Server/Scripting/LuaMathTypes.hpp>
 #include <optional>
 #include <unordered_map>
@@ -30,9 +31,12 @@ namespace ewn
 			~RadarModule() = default;
 
 			inline const Ndk::EntityHandle& FindEntityBySignature(Nz::Int64 signature) const;
+			void Initialize(Ndk::Entity* spaceship) override;
 			void PushInstance(Nz::LuaState& lua) override;
-			void RegisterModule(Nz::LuaClass<SpaceshipModule>& parentBinding, Nz::LuaState& lua) override;
-			void Run(float elapsedTime) override;
+			void RegisterModule(Nz::LuaState& lua) override;
+
+			static void BindModule(Nz::LuaClass<SpaceshipModule>& parentBinding);
+			static void UnbindModule();
 
 			// Lua API
 			inline void EnablePassiveScan(bool enable);
@@ -67,16 +71,16 @@ namespace ewn
 			};
 
 		private:
-			void PerformScan();
+			void OnContactsUpdate(RadarComponent* radar, const Nz::Vector3f& radarPosition, const std::vector<const BroadphaseSystem::EntityData*>& newContacts, const std::vector<RadarComponent::Contact>& lostContacts);
 			inline void RemoveEntityFromRadius(Ndk::Entity* entity);
 
+			NazaraSlot(RadarComponent, OnContactsUpdate, m_onContactsUpdateSlot);
+
 			std::size_t m_maxLockableTargets;
 			std::unordered_map<Nz::Int64 /*signature*/, Ndk::EntityHandle /*entity*/> m_signatureToEntity;
 			Ndk::EntityList m_entitiesInRadius;
 			Ndk::EntityId m_lockedEntity;
-			Nz::UInt64 m_lastPassiveScanTime;
 			float m_detectionRadius;
-			bool m_isPassiveScanEnabled;
 
 			static std::optional<Nz::LuaClass<RadarModuleHandle>> s_binding;
 	};
@@ -7,10 +7,9 @@
 namespace ewn
 {
 	inline RadarModule::RadarModule(SpaceshipCore* core, const Ndk::EntityHandle & spaceship, float detectionRadius, std::size_t maxLockableTarget) :
-	SpaceshipModule(ModuleType::Radar, core, spaceship, true),
+	SpaceshipModule(ModuleType::Radar, core, spaceship),
 	m_maxLockableTargets(maxLockableTarget),
-	m_detectionRadius(detectionRadius),
-	m_isPassiveScanEnabled(true)
+	m_detectionRadius(detectionRadius)
 	{
 	}
 
@@ -25,12 +24,12 @@ namespace ewn
 
 	inline void RadarModule::EnablePassiveScan(bool enable)
 	{
-		m_isPassiveScanEnabled = enable;
+		GetSpaceship()->GetComponent<RadarComponent>().EnablePassiveScan(enable);
 	}
 
 	inline bool RadarModule::IsPassiveScanEnabled() const
 	{
-		return m_isPassiveScanEnabled;
+		return GetSpaceship()->GetComponent<RadarComponent>().IsPassiveScanEnabled();
 	}
 
 	inline void RadarModule::RemoveEntityFromRadius(Ndk::Entity* entity)
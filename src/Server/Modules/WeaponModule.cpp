@@ -12,22 +12,27 @@ namespace ewn
 		lua.Push(this);
 	}
 
-	void WeaponModule::RegisterModule(Nz::LuaClass<SpaceshipModule>& parentBinding, Nz::LuaState& lua)
+	void WeaponModule::BindModule(Nz::LuaClass<SpaceshipModule>& parentBinding)
 	{
-		if (!s_binding)
+		s_binding.emplace("Weapon");
+		s_binding->Inherit<SpaceshipModule>(parentBinding, [](WeaponModuleHandle* moduleRef) -> SpaceshipModule*
 		{
-			s_binding.emplace("Weapon");
-			s_binding->Inherit<SpaceshipModule>(parentBinding, [](WeaponModuleHandle* moduleRef) -> SpaceshipModule*
-			{
-				return moduleRef->GetObject();
-			});
+			return moduleRef->GetObject();
+		});
 
-			s_binding->BindMethod("Shoot", &WeaponModule::Shoot);
-		}
+		s_binding->BindMethod("Shoot", &WeaponModule::Shoot);
+	}
 
+	void WeaponModule::RegisterModule(Nz::LuaState& lua)
+	{
 		s_binding->Register(lua);
 	}
 
+	void WeaponModule::UnbindModule()
+	{
+		s_binding.reset();
+	}
+
 	void WeaponModule::Shoot()
 	{
 		Nz::UInt64 currentTime = Nz::GetElapsedMilliseconds();
@@ -36,7 +41,11 @@ namespace ewn
 
 		m_lastShootTime = currentTime;
 
-		DoShoot();
+		// Spawns entities, wait for the script system to apply it
+		GetCore()->PostCommand([this]()
+		{
+			DoShoot();
+		});
 	}
 
 	std::optional<Nz::LuaClass<WeaponModuleHandle>> WeaponModule::s_binding;
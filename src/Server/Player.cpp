@@ -11,16 +11,24 @@
 #include <Server/Components/InputComponent.hpp>
 #include <Server/Components/PlayerControlledComponent.hpp>
 #include <Server/Components/ScriptComponent.hpp>
+#include <Shared/Protocol/ArenaStateHistory.hpp>
 #include <cassert>
 
 namespace ewn
 {
 	Player::Player(ServerApplication* app) :
 	m_arena(nullptr),
+	m_permissionLevel(0),
+	m_stateBandwidth(0),
+	m_leavingArena(nullptr),
+	m_targetArena(nullptr),
 	m_session(nullptr),
 	m_app(app),
-	m_permissionLevel(0),
 	m_databaseId(0),
+	m_lastSentStateId(0),
+	m_nextStateId(0),
+	m_acknowledgedStateMask(0),
+	m_sentStateMask(0),
 	m_lastInputTime(0),
 	m_authenticated(false)
 	{
@@ -28,8 +36,25 @@ namespace ewn
 
 	Player::~Player()
 	{
-		if (m_arena)
-			m_arena->HandlePlayerLeave(this);
+		// Arenas are no longer updated at this point (server shutdown), otherwise the player would have left through the arena mailbox
+		if (Arena* arena = m_arena.load(std::memory_order_acquire))
+			arena->HandlePlayerLeave(this);
+	}
+
+	void Player::AcknowledgeArenaState(Nz::UInt16 stateId)
+	{
+		// Only states we sent to this player in its current arena can be used as baselines
+		Nz::UInt16 offset = m_lastSentStateId - stateId;
+		if (offset >= 32 || (m_sentStateMask & (1U << offset)) == 0)
+			return;
+
+		m_acknowledgedStateMask |= 1U << offset;
+
+		// Acknowledgments are unreliable and may arrive out of order, keep the most recent one
+		if (m_acknowledgedStateId && static_cast<Nz::UInt16>(m_lastSentStateId - *m_acknowledgedStateId) < offset)
+			return;
+
+		m_acknowledgedStateId = stateId;
 	}
 
 	void Player::Authenticate(Nz::Int32 dbId, std::function<void(Player*, bool succeeded)> authenticationCallback)
@@ -275,10 +300,32 @@ namespace ewn
 		if (m_botEntities.size() >= MaxBots)
 			m_botEntities.erase(m_botEntities.begin());
 
-		m_botEntities.emplace_back(m_arena->CreateSpaceship(name + " bot (" + m_login + ')', this, spaceshipHullId, position, rotation));
+		m_botEntities.emplace_back(GetArena()->CreateSpaceship(name + " bot (" + m_login + ')', this, spaceshipHullId, position, rotation));
 
 		return m_botEntities.back();
 	}
+
+	const Packets::ArenaState* Player::GetArenaStateBaseline() const
+	{
+		// Baseline the next state we send will be encoded against, if any
+		Nz::UInt8 baselineOffset = GetArenaStateBaselineOffset(m_nextStateId);
+		if (baselineOffset == 0)
+			return nullptr;
+
+		return m_stateHistory.GetState(static_cast<Nz::UInt16>(m_nextStateId - baselineOffset));
+	}
+
+	Nz::UInt8 Player::GetArenaStateBaselineOffset(Nz::UInt16 stateId) const
+	{
+		if (!m_acknowledgedStateId)
+			return 0;
+
+		Nz::UInt16 offset = stateId - *m_acknowledgedStateId;
+		if (offset == 0 || offset >= ArenaStateHistory::MaxStateCount)
+			return 0;
+
+		return static_cast<Nz::UInt8>(offset);
+	}
 
 	Nz::UInt64 Player::GetLastInputProcessedTime() const
 	{
@@ -293,14 +340,53 @@ namespace ewn
 
 	void Player::MoveToArena(Arena* arena)
 	{
-		assert(m_arena != arena);
+		// Arenas may run on their own thread, so joining/leaving them goes through their mailbox
+		// m_targetArena is where the player is heading to, m_arena is only updated once the arena processed the move
+		if (m_targetArena == arena)
+			return;
+
+		Arena* previousArena = m_targetArena;
+		m_targetArena = arena;
+
+		// Target arena will be joined once we're done leaving the previous one
+		if (m_leavingArena)
+			return;
+
+		if (previousArena)
+		{
+			m_leavingArena = previousArena;
+
+			previousArena->PostCommand([app = m_app, arena = previousArena, player = shared_from_this()]()
+			{
+				arena->HandlePlayerLeave(player.get());
+				player->ClearBots();
+				player->m_arena.store(nullptr, std::memory_order_release);
+
+				app->RegisterCallback([player]()
+				{
+					player->OnArenaLeft();
+				});
+			});
+		}
+		else
+			JoinTargetArena();
+	}
+
+	bool Player::PostArenaCommand(std::function<void()> command)
+	{
+		if (!m_targetArena)
+			return false;
+
+		m_targetArena->PostCommand([arena = m_targetArena, player = shared_from_this(), cmd = std::move(command)]()
+		{
+			// Player may have left this arena in the meantime
+			if (player->GetArena() != arena)
+				return;
 
-		if (m_arena)
-			m_arena->HandlePlayerLeave(this);
+			cmd();
+		});
 
-		m_arena = arena;
-		if (m_arena)
-			m_arena->HandlePlayerJoin(this);
+		return true;
 	}
 
 	void Player::PrintMessage(std::string chatMessage)
@@ -311,6 +397,45 @@ namespace ewn
 		SendPacket(chatPacket);
 	}
 
+	void Player::RegisterSentArenaState(Nz::UInt16 stateId)
+	{
+		static_assert(ArenaStateHistory::MaxStateCount <= 32);
+
+		Nz::UInt16 offset = stateId - m_lastSentStateId;
+		if (m_sentStateMask == 0 || offset >= 32)
+		{
+			m_acknowledgedStateMask = 0;
+			m_sentStateMask = 1;
+		}
+		else
+		{
+			m_acknowledgedStateMask <<= offset;
+			m_sentStateMask = (m_sentStateMask << offset) | 1;
+		}
+
+		m_lastSentStateId = stateId;
+	}
+
+	void Player::SendArenaState(Packets::ArenaState& statePacket)
+	{
+		statePacket.stateId = m_nextStateId++;
+		statePacket.lastProcessedInputTime = GetLastInputProcessedTime();
+		m_stateHistory.PushState(statePacket);
+
+		// Send it as a delta against the last state the client acknowledged, if it's still in our history
+		Nz::UInt8 baselineOffset = GetArenaStateBaselineOffset(statePacket.stateId);
+		const Packets::ArenaState* baseline = (baselineOffset != 0) ? m_stateHistory.GetState(static_cast<Nz::UInt16>(statePacket.stateId - baselineOffset)) : nullptr;
+		if (baseline)
+		{
+			ArenaStateHistory::EncodeDelta(*baseline, statePacket, m_deltaStatePacket);
+			SendPacket(m_deltaStatePacket);
+		}
+		else
+			SendPacket(statePacket);
+
+		RegisterSentArenaState(statePacket.stateId);
+	}
+
 	void Player::Shoot()
 	{
 		if (!m_controlledEntity)
@@ -329,13 +454,14 @@ namespace ewn
 
 		auto& spaceshipNode = m_controlledEntity->GetComponent<Ndk::NodeComponent>();
 
-		m_arena->CreatePlasmaProjectile(this, m_controlledEntity, spaceshipNode.GetPosition() + spaceshipNode.GetForward() * 12.f, spaceshipNode.GetRotation());
+		Arena* arena = GetArena();
+		arena->CreatePlasmaProjectile(this, m_controlledEntity, spaceshipNode.GetPosition() + spaceshipNode.GetForward() * 12.f, spaceshipNode.GetRotation());
 
 		Packets::PlaySound playSound;
 		playSound.position = spaceshipNode.GetPosition();
 		playSound.soundId = 0;
 
-		m_arena->BroadcastPacket(playSound, this);
+		arena->BroadcastPacket(playSound, this);
 	}
 
 	void Player::Update(float elapsedTime)
@@ -437,7 +563,7 @@ namespace ewn
 	{
 		assert(m_authenticated);
 
-		m_permissionLevel = permissionLevel;
+		m_permissionLevel.store(permissionLevel, std::memory_order_relaxed);
 		m_app->GetGlobalDatabase().ExecuteStatement("UpdatePermissionLevel", { Nz::Int32(m_databaseId), Nz::Int16(permissionLevel) }, [cb = std::move(databaseCallback)](DatabaseResult& result)
 		{
 			if (!result.IsValid())
@@ -455,11 +581,30 @@ namespace ewn
 		m_session = session;
 	}
 
+	void Player::JoinTargetArena()
+	{
+		assert(m_targetArena);
+
+		m_targetArena->PostCommand([arena = m_targetArena, player = shared_from_this()]()
+		{
+			player->m_arena.store(arena, std::memory_order_release);
+			arena->HandlePlayerJoin(player.get());
+		});
+	}
+
+	void Player::OnArenaLeft()
+	{
+		m_leavingArena = nullptr;
+
+		if (m_targetArena)
+			JoinTargetArena();
+	}
+
 	void Player::OnAuthenticated(std::string login, std::string displayName, Nz::UInt16 permissionLevel)
 	{
 		m_displayName = std::move(displayName);
 		m_login = std::move(login);
-		m_permissionLevel = permissionLevel;
+		m_permissionLevel.store(permissionLevel, std::memory_order_relaxed);
 
 		m_authenticated = true;
 	}
@@ -12,8 +12,13 @@
 #include <Nazara/Math/Box.hpp>
 #include <NDK/EntityOwner.hpp>
 #include <Shared/NetworkReactor.hpp>
+#include <Shared/Protocol/ArenaStateHistory.hpp>
 #include <Server/ClientSession.hpp>
 #include <Server/ServerCommandStore.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
 
 namespace ewn
 {
@@ -23,7 +28,7 @@ namespace ewn
 
 	using PlayerHandle = Nz::ObjectHandle<Player>;
 
-	class Player : public Nz::HandledObject<Player>
+	class Player : public Nz::HandledObject<Player>, public std::enable_shared_from_this<Player>
 	{
 		public:
 			struct FleetData;
@@ -31,6 +36,7 @@ namespace ewn
 			Player(ServerApplication* app);
 			~Player();
 
+			void AcknowledgeArenaState(Nz::UInt16 stateId);
 			void Authenticate(Nz::Int32 dbId, std::function<void (Player*, bool succeeded)> authenticationCallback);
 
 			bool CanShoot() const;
@@ -42,10 +48,13 @@ namespace ewn
 
 			inline void Disconnect(Nz::UInt32 data = 0);
 
+			inline std::optional<Nz::UInt16> GetAcknowledgedArenaStateId() const;
 			inline ServerApplication* GetApp() const;
 			inline Arena* GetArena() const;
+			const Packets::ArenaState* GetArenaStateBaseline() const;
 			inline const Ndk::EntityHandle& GetControlledEntity() const;
 			inline Nz::Int32 GetDatabaseId() const;
+			inline Arena* GetLeavingArena() const;
 			void GetFleetData(const std::string& fleetName, std::function<void(bool found, const FleetData& fleet)> callback, SpaceshipQueryInfoFlags infoFlags = SpaceshipQueryInfoFlags::ValueMask);
 			Nz::UInt64 GetLastInputProcessedTime() const;
 			inline const std::string& GetLogin() const;
@@ -54,16 +63,24 @@ namespace ewn
 			inline ClientSession* GetSession();
 			inline const ClientSession* GetSession() const;
 			inline std::size_t GetSessionId() const;
+			inline Nz::UInt32 GetStateBandwidth() const;
 
 			const Ndk::EntityHandle& InstantiateBot(const std::string& name, std::size_t spaceshipHullId, Nz::Vector3f positionOffset = Nz::Vector3f::Zero());
 
+			inline bool IsArenaStateAcknowledged(Nz::UInt16 stateId) const;
 			inline bool IsAuthenticated() const;
 
 			void MoveToArena(Arena* arena);
 
+			bool PostArenaCommand(std::function<void()> command);
+
 			void PrintMessage(std::string chatMessage);
 
+			inline void ResetArenaStateSync();
+
+			void SendArenaState(Packets::ArenaState& statePacket);
 			template<typename T> void SendPacket(const T& packet);
+			inline void SendPacket(const SharedPacket& packet);
 
 			void Shoot();
 
@@ -73,6 +90,7 @@ namespace ewn
 			void UpdateInput(Nz::UInt64 time, Nz::Vector3f direction, Nz::Vector3f rotation);
 			void UpdatePermissionLevel(Nz::UInt16 permissionLevel, std::function<void(bool updateSucceeded)> databaseCallback = nullptr);
 			void UpdateSession(ClientSession* session);
+			inline void UpdateStateBandwidth(Nz::UInt32 bandwidth);
 
 			struct FleetData
 			{
@@ -102,8 +120,15 @@ namespace ewn
 			static constexpr std::size_t InvalidSessionId = std::numeric_limits<std::size_t>::max();
 
 		private:
+			Nz::UInt8 GetArenaStateBaselineOffset(Nz::UInt16 stateId) const;
+
+			void JoinTargetArena();
+
+			void OnArenaLeft();
 			void OnAuthenticated(std::string login, std::string displayName, Nz::UInt16 permissionLevel);
 
+			void RegisterSentArenaState(Nz::UInt16 stateId);
+
 			struct NoAction
 			{
 			};
@@ -112,16 +137,26 @@ namespace ewn
 			{
 			};
 
-			Arena* m_arena;
+			std::atomic<Arena*> m_arena;
+			std::atomic<Nz::UInt16> m_permissionLevel; //< set by the server thread, read by arena threads
+			std::atomic<Nz::UInt32> m_stateBandwidth; //< bytes per second, estimated by the session
+			Arena* m_leavingArena;
+			Arena* m_targetArena;
 			ClientSession* m_session;
 			ServerApplication* m_app;
 			std::string m_displayName;
 			std::string m_login;
 			std::variant<NoAction, ShootAction> m_pendingAction;
+			std::optional<Nz::UInt16> m_acknowledgedStateId;
+			ArenaStateHistory m_stateHistory;
+			Packets::ArenaState m_deltaStatePacket;
 			std::vector<Ndk::EntityOwner> m_botEntities;
 			Ndk::EntityHandle m_controlledEntity;
 			Nz::Int32 m_databaseId;
-			Nz::UInt16 m_permissionLevel;
+			Nz::UInt16 m_lastSentStateId;
+			Nz::UInt16 m_nextStateId;
+			Nz::UInt32 m_acknowledgedStateMask; //< bit N is set if state m_lastSentStateId - N was acknowledged
+			Nz::UInt32 m_sentStateMask; //< bit N is set if state m_lastSentStateId - N was sent
 			Nz::UInt64 m_lastInputTime;
 			Nz::UInt64 m_lastShootTime;
 			bool m_authenticated;
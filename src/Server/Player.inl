@@ -19,6 +19,11 @@ namespace ewn
 		m_session->Disconnect(data);
 	}
 
+	inline std::optional<Nz::UInt16> Player::GetAcknowledgedArenaStateId() const
+	{
+		return m_acknowledgedStateId;
+	}
+
 	inline ServerApplication* Player::GetApp() const
 	{
 		return m_app;
@@ -26,7 +31,7 @@ namespace ewn
 
 	inline Arena* Player::GetArena() const
 	{
-		return m_arena;
+		return m_arena.load(std::memory_order_acquire);
 	}
 
 	const Ndk::EntityHandle& Player::GetControlledEntity() const
@@ -39,6 +44,11 @@ namespace ewn
 		return m_databaseId;
 	}
 
+	inline Arena* Player::GetLeavingArena() const
+	{
+		return m_leavingArena;
+	}
+
 	inline const std::string& Player::GetLogin() const
 	{
 		return m_login;
@@ -46,7 +56,7 @@ namespace ewn
 
 	inline Nz::UInt16 Player::GetPermissionLevel() const
 	{
-		return m_permissionLevel;
+		return m_permissionLevel.load(std::memory_order_relaxed);
 	}
 
 	inline const std::string& Player::GetName() const
@@ -72,11 +82,31 @@ namespace ewn
 			return InvalidSessionId;
 	}
 
+	inline Nz::UInt32 Player::GetStateBandwidth() const
+	{
+		return m_stateBandwidth.load(std::memory_order_relaxed);
+	}
+
+	inline bool Player::IsArenaStateAcknowledged(Nz::UInt16 stateId) const
+	{
+		Nz::UInt16 offset = m_lastSentStateId - stateId;
+		return offset < 32 && (m_acknowledgedStateMask & (1U << offset)) != 0;
+	}
+
 	inline bool Player::IsAuthenticated() const
 	{
 		return m_authenticated;
 	}
 
+	inline void Player::ResetArenaStateSync()
+	{
+		// State ids keep increasing across arenas, so acknowledgments from the previous arena can't be mistaken for new ones
+		m_acknowledgedStateId.reset();
+		m_acknowledgedStateMask = 0;
+		m_sentStateMask = 0;
+		m_stateHistory.Clear();
+	}
+
 	template<typename T>
 	void Player::SendPacket(const T& packet)
 	{
@@ -85,4 +115,17 @@ namespace ewn
 
 		m_session->SendPacket(packet);
 	}
+
+	inline void Player::SendPacket(const SharedPacket& packet)
+	{
+		if (!m_session)
+			return;
+
+		m_session->SendPacket(packet);
+	}
+
+	inline void Player::UpdateStateBandwidth(Nz::UInt32 bandwidth)
+	{
+		m_stateBandwidth.store(bandwidth, std::memory_order_relaxed);
+	}
 }
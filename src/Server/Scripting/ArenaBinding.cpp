@@ -15,7 +15,7 @@ namespace ewn
 	{
 		s_arenaBinding.Reset("Arena");
 		
-		s_arenaBinding.BindMethod("CreateEntity", &Arena::CreateEntity);
+		s_arenaBinding.BindMethod("CreateEntity", Overload<std::string, std::string, Player*, const Nz::Vector3f&, const Nz::Quaternionf&>(&Arena::CreateEntity));
 		s_arenaBinding.BindMethod("CreateSpaceship", &Arena::CreateSpaceship);
 		s_arenaBinding.BindMethod("FindPlayerByName", &Arena::FindPlayerByName);
 		s_arenaBinding.BindMethod("GetName", &Arena::GetName);
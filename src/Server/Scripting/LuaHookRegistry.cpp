@@ -0,0 +1,31 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Scripting/LuaHookRegistry.hpp>
+
+namespace ewn
+{
+	void LuaHookRegistry::Invalidate(Nz::LuaState& state)
+	{
+		for (int reference : m_references)
+		{
+			if (reference >= 0)
+				state.DestroyReference(reference);
+		}
+
+		m_references.clear();
+	}
+
+	void LuaHookRegistry::Invalidate(Nz::LuaState& state, std::size_t hookId)
+	{
+		if (hookId >= m_references.size())
+			return;
+
+		int& reference = m_references[hookId];
+		if (reference >= 0)
+			state.DestroyReference(reference);
+
+		reference = UnresolvedHook;
+	}
+}
@@ -0,0 +1,37 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SCRIPTING_LUA_HOOK_REGISTRY_HPP
+#define EREWHON_SCRIPTING_LUA_HOOK_REGISTRY_HPP
+
+#include <Nazara/Lua/LuaState.hpp>
+#include <vector>
+
+namespace ewn
+{
+	class LuaHookRegistry
+	{
+		public:
+			LuaHookRegistry() = default;
+			~LuaHookRegistry() = default;
+
+			void Invalidate(Nz::LuaState& state);
+			void Invalidate(Nz::LuaState& state, std::size_t hookId);
+
+			template<typename F> bool Push(Nz::LuaState& state, std::size_t hookId, F&& lookup);
+
+		private:
+			// Same values as LUA_NOREF and LUA_REFNIL, which are ignored when releasing references
+			static constexpr int UnresolvedHook = -2;
+			static constexpr int MissingHook = -1;
+
+			std::vector<int> m_references;
+	};
+}
+
+#include <Server/Scripting/LuaHookRegistry.inl>
+
+#endif // EREWHON_SCRIPTING_LUA_HOOK_REGISTRY_HPP
@@ -0,0 +1,34 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Scripting/LuaHookRegistry.hpp>
+
+namespace ewn
+{
+	template<typename F>
+	bool LuaHookRegistry::Push(Nz::LuaState& state, std::size_t hookId, F&& lookup)
+	{
+		if (hookId >= m_references.size())
+			m_references.resize(hookId + 1, UnresolvedHook);
+
+		int& reference = m_references[hookId];
+		if (reference == UnresolvedHook)
+		{
+			// Lookup pushes exactly one value, only keep it if it can be called
+			if (lookup(state) == Nz::LuaType_Function)
+				reference = state.CreateReference();
+			else
+			{
+				state.Pop();
+				reference = MissingHook;
+			}
+		}
+
+		if (reference == MissingHook)
+			return false;
+
+		state.PushReference(reference);
+		return true;
+	}
+}
@@ -26,7 +26,6 @@ namespace ewn
 		s_playerBinding.BindMethod("GetPermissionLevel", &Player::GetPermissionLevel);
 		s_playerBinding.BindMethod("GetSessionId", &Player::GetSessionId);
 		s_playerBinding.BindMethod("InstantiateBot", &Player::InstantiateBot);
-		s_playerBinding.BindMethod("MoveToArena", &Player::MoveToArena);
 		s_playerBinding.BindMethod("PrintMessage", &Player::PrintMessage);
 		s_playerBinding.BindMethod("Shoot", &Player::Shoot);
 		s_playerBinding.BindMethod("UpdateControlledEntity", &Player::UpdateControlledEntity);
@@ -41,80 +40,100 @@ namespace ewn
 
 			Arena* arena = instance->GetArena();
 
-			instance->GetFleetData(fleetName, [arena, callbackRef](bool success, const Player::FleetData& fleetData)
+			instance->GetFleetData(fleetName, [arena, callbackRef](bool success, const Player::FleetData& fleet)
 			{
-				Nz::LuaInstance& luaInstance = arena->GetLuaInstance();
-				luaInstance.PushReference(callbackRef);
-				if (!luaInstance.IsValid(-1))
+				// Database callbacks are run from the main thread
+				arena->PostCommand([arena, callbackRef, success, fleetData = fleet]()
 				{
-					luaInstance.Pop();
-					return;
-				}
-
-				if (!success)
-				{
-					luaInstance.Call(0);
-					return;
-				}
+					Nz::LuaInstance& luaInstance = arena->GetLuaInstance();
+					luaInstance.PushReference(callbackRef);
+					if (!luaInstance.IsValid(-1))
+					{
+						luaInstance.Pop();
+						return;
+					}
 
-				luaInstance.PushTable(0, 2);
-				{
-					luaInstance.PushField("fleetId", fleetData.fleetId);
-					luaInstance.PushField("fleetName", fleetData.fleetName);
+					if (!success)
+					{
+						luaInstance.Call(0);
+						return;
+					}
 
-					luaInstance.PushTable(fleetData.spaceshipTypes.size(), 0);
+					luaInstance.PushTable(0, 2);
 					{
-						std::size_t spaceshipIndex = 1;
-						for (const auto& spaceshipData : fleetData.spaceshipTypes)
-						{
-							luaInstance.PushInteger(spaceshipIndex++);
+						luaInstance.PushField("fleetId", fleetData.fleetId);
+						luaInstance.PushField("fleetName", fleetData.fleetName);
 
-							luaInstance.PushTable(0, 8);
+						luaInstance.PushTable(fleetData.spaceshipTypes.size(), 0);
+						{
+							std::size_t spaceshipIndex = 1;
+							for (const auto& spaceshipData : fleetData.spaceshipTypes)
 							{
-								luaInstance.PushField("spaceshipId", spaceshipData.spaceshipId);
-								luaInstance.PushField("hullId", spaceshipData.hullId);
-								luaInstance.PushField("collisionMeshId", spaceshipData.collisionMeshId);
-								luaInstance.PushField("script", spaceshipData.script);
-								luaInstance.PushField("name", spaceshipData.name);
+								luaInstance.PushInteger(spaceshipIndex++);
 
-								luaInstance.PushTable(spaceshipData.modules.size(), 0);
+								luaInstance.PushTable(0, 8);
 								{
-									std::size_t moduleIndex = 1;
-									for (std::size_t moduleId : spaceshipData.modules)
+									luaInstance.PushField("spaceshipId", spaceshipData.spaceshipId);
+									luaInstance.PushField("hullId", spaceshipData.hullId);
+									luaInstance.PushField("collisionMeshId", spaceshipData.collisionMeshId);
+									luaInstance.PushField("script", spaceshipData.script);
+									luaInstance.PushField("name", spaceshipData.name);
+
+									luaInstance.PushTable(spaceshipData.modules.size(), 0);
 									{
-										luaInstance.Push(moduleIndex++);
-										luaInstance.Push(moduleId);
-										luaInstance.SetTable();
+										std::size_t moduleIndex = 1;
+										for (std::size_t moduleId : spaceshipData.modules)
+										{
+											luaInstance.Push(moduleIndex++);
+											luaInstance.Push(moduleId);
+											luaInstance.SetTable();
+										}
 									}
+									luaInstance.SetField("modules");
 								}
-								luaInstance.SetField("modules");
-							}
 
-							luaInstance.SetTable();
+								luaInstance.SetTable();
+							}
 						}
-					}
-					luaInstance.SetField("spaceshipTypes");
+						luaInstance.SetField("spaceshipTypes");
 
-					luaInstance.PushTable(fleetData.spaceships.size(), 0);
-					{
-						std::size_t spaceshipIndex = 1;
-						for (const auto& spaceshipData : fleetData.spaceships)
+						luaInstance.PushTable(fleetData.spaceships.size(), 0);
 						{
-							luaInstance.PushInteger(spaceshipIndex++);
-
-							luaInstance.PushTable(0, 2);
+							std::size_t spaceshipIndex = 1;
+							for (const auto& spaceshipData : fleetData.spaceships)
 							{
-								luaInstance.PushField("spaceshipType", spaceshipData.spaceshipType + 1);
-								luaInstance.PushField("position", spaceshipData.position);
-							}
+								luaInstance.PushInteger(spaceshipIndex++);
+
+								luaInstance.PushTable(0, 2);
+								{
+									luaInstance.PushField("spaceshipType", spaceshipData.spaceshipType + 1);
+									luaInstance.PushField("position", spaceshipData.position);
+								}
 
-							luaInstance.SetTable();
+								luaInstance.SetTable();
+							}
 						}
+						luaInstance.SetField("spaceships");
 					}
-					luaInstance.SetField("spaceships");
-				}
 
-				luaInstance.Call(1);
+					luaInstance.Call(1);
+				});
+			});
+
+			return 0;
+		});
+
+		s_playerBinding.BindMethod("MoveToArena", [](Nz::LuaState& state, Player* instance, std::size_t argumentCount) -> int
+		{
+			int argIndex = 2;
+			Arena* arena = state.Check<Arena*>(&argIndex);
+
+			// Arena moves are handled by the main thread
+			ServerApplication* app = instance->GetApp();
+			app->RegisterCallback([app, arena, sessionId = instance->GetSessionId()]()
+			{
+				if (Player* player = app->GetPlayerBySession(sessionId))
+					player->MoveToArena(arena);
 			});
 
 			return 0;
@@ -3,17 +3,29 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/ServerApplication.hpp>
+#include <Nazara/Core/Clock.hpp>
 #include <Nazara/Core/File.hpp>
+#include <Shared/SecureRandomGenerator.hpp>
+#include <Shared/Utils.hpp>
 #include <Server/DatabaseLoader.hpp>
 #include <Server/Player.hpp>
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 namespace ewn
 {
 	ServerApplication::ServerApplication() :
 	m_sessionPool(sizeof(ClientSession)),
 	m_chatCommandStore(this),
-	m_nextSessionId(0)
+	m_overBudgetTickCount(0),
+	m_nextSessionId(0),
+	m_lastTickTimings(),
+	m_worstTickTimings(),
+	m_lastPeerInfoQuery(0),
+	m_lastTickBudgetReport(0),
+	m_worstTickTime(0),
+	m_firstPort(0)
 	{
 		RegisterConfigOptions();
 		RegisterNetworkedStrings();
@@ -21,6 +33,9 @@ namespace ewn
 
 	ServerApplication::~ServerApplication()
 	{
+		// Stop arena threads first, players may still be in an arena
+		m_arenaWorkers.clear();
+
 		for (ClientSession* session : m_sessions)
 		{
 			if (session)
@@ -34,7 +49,12 @@ namespace ewn
 	Arena& ServerApplication::CreateArena(std::string name, std::string script)
 	{
 		m_arenas.emplace_back(std::make_unique<Arena>(this, std::move(name), std::move(script)));
-		return *m_arenas.back().get();
+		Arena& arena = *m_arenas.back().get();
+
+		if (m_config.GetBoolOption("Game.ArenaThreads"))
+			m_arenaWorkers.emplace_back(std::make_unique<ArenaWorker>(arena, m_config.GetIntegerOption<unsigned int>("Game.TickRate")));
+
+		return arena;
 	}
 
 	bool ServerApplication::LoadDatabase()
@@ -71,17 +91,63 @@ namespace ewn
 
 	bool ServerApplication::Run()
 	{
-		float updateTime = GetUpdateTime();
-		for (const auto& arenaPtr : m_arenas)
-			arenaPtr->Update(updateTime);
+		assert(m_tickScheduler);
+
+		unsigned int tickCount = m_tickScheduler->WaitNextTick();
+
+		Nz::UInt64 tickStart = Nz::GetElapsedMicroseconds();
+
+		// Arenas running on their own thread are updated by their worker
+		if (m_arenaWorkers.empty())
+		{
+			float tickDuration = m_tickScheduler->GetTickDuration();
+			for (unsigned int i = 0; i < tickCount; ++i)
+			{
+				for (const auto& arenaPtr : m_arenas)
+					arenaPtr->Update(tickDuration);
+			}
+		}
+
+		Nz::UInt64 worldUpdateEnd = Nz::GetElapsedMicroseconds();
 
 		m_globalDatabase->Poll();
 
+		Nz::UInt64 databasePollEnd = Nz::GetElapsedMicroseconds();
+
 		ServerCallback func;
 		while (m_callbackQueue.try_dequeue(func))
 			func();
 
-		return BaseApplication::Run();
+		// Regularly query connection quality, to adapt state bandwidth of players
+		constexpr Nz::UInt64 PeerInfoQueryInterval = 500;
+
+		Nz::UInt64 appTime = GetAppTime();
+		if (appTime - m_lastPeerInfoQuery >= PeerInfoQueryInterval)
+		{
+			for (ClientSession* session : m_sessions)
+			{
+				if (session)
+					session->QueryInfo();
+			}
+
+			m_lastPeerInfoQuery = appTime;
+		}
+
+		Nz::UInt64 callbacksEnd = Nz::GetElapsedMicroseconds();
+
+		bool running = BaseApplication::Run();
+
+		Nz::UInt64 tickEnd = Nz::GetElapsedMicroseconds();
+
+		m_lastTickTimings.callbacks = callbacksEnd - databasePollEnd;
+		m_lastTickTimings.databasePoll = databasePollEnd - worldUpdateEnd;
+		m_lastTickTimings.network = tickEnd - callbacksEnd;
+		m_lastTickTimings.worldUpdate = worldUpdateEnd - tickStart;
+		m_lastTickTimings.tickCount = tickCount;
+
+		UpdateTickBudget(tickEnd, tickEnd - tickStart);
+
+		return running;
 	}
 
 	bool ServerApplication::BakeDefaultSpaceshipData()
@@ -153,16 +219,40 @@ namespace ewn
 
 	void ServerApplication::HandlePeerConnection(bool outgoing, std::size_t peerId, Nz::UInt32 data)
 	{
-		const std::unique_ptr<NetworkReactor>& reactor = GetReactor(peerId / GetPeerPerReactor());
+		std::size_t reactorId = peerId / GetPeerPerReactor();
+		const std::unique_ptr<NetworkReactor>& reactor = GetReactor(reactorId);
 
 		if (peerId >= m_sessions.size())
 			m_sessions.resize(peerId + 1);
 
+		std::size_t sessionId;
+		if (data != 0)
+		{
+			// Client is coming back from a redirection, its session was allocated by the first reactor
+			auto it = m_pendingRedirects.find(data);
+			if (it == m_pendingRedirects.end() || it->second.reactorId != reactorId || GetAppTime() > it->second.expirationTime)
+			{
+				std::cout << "Client #" << peerId << " connected with invalid redirection token " << data << std::endl;
+				reactor->DisconnectPeer(peerId, 0, DisconnectionType::Kick);
+				return;
+			}
+
+			sessionId = it->second.sessionId;
+			m_pendingRedirects.erase(it);
+		}
+		else
+		{
+			sessionId = m_nextSessionId++;
+
+			// Spread sessions across reactors, clients connecting on the wrong one are told which port to use
+			std::size_t targetReactorId = JumpConsistentHash(sessionId, GetReactorCount());
+			if (targetReactorId != reactorId && RedirectPeer(peerId, sessionId, targetReactorId))
+				return;
+		}
+
 		auto player = std::make_shared<Player>(this);
 
-		std::size_t sessionId = m_nextSessionId;
 		m_sessionIdToPeer.insert_or_assign(sessionId, peerId);
-		m_nextSessionId++;
 
 		m_sessions[peerId] = m_sessionPool.New<ClientSession>(this, sessionId, peerId, player, *reactor, m_commandStore);
 
@@ -176,18 +266,51 @@ namespace ewn
 
 	void ServerApplication::HandlePeerDisconnection(std::size_t peerId, Nz::UInt32 data)
 	{
-		std::cout << "Client #" << peerId << " disconnected with data " << data << std::endl;
+		// Redirected peers never had a session
+		if (peerId >= m_sessions.size() || !m_sessions[peerId])
+			return;
 
-		m_sessionIdToPeer.erase(m_sessions[peerId]->GetSessionId());
+		std::cout << "Client #" << peerId << " disconnected with data " << data << std::endl;
 
-		m_sessionPool.Delete(m_sessions[peerId]);
+		ClientSession* session = m_sessions[peerId];
+		m_sessionIdToPeer.erase(session->GetSessionId());
 		m_sessions[peerId] = nullptr;
+
+		Player* player = session->GetPlayer();
+		player->MoveToArena(nullptr);
+
+		// Arena may still send packets through this session until it processed the player leave
+		if (Arena* arena = player->GetLeavingArena())
+		{
+			arena->PostCommand([this, session]()
+			{
+				RegisterCallback([this, session]()
+				{
+					m_sessionPool.Delete(session);
+				});
+			});
+		}
+		else
+			m_sessionPool.Delete(session);
+	}
+
+	void ServerApplication::HandlePeerInfo(std::size_t peerId, const NetworkReactor::PeerInfo& peerInfo)
+	{
+		// Peer may have disconnected or been redirected in the meantime
+		if (peerId >= m_sessions.size() || !m_sessions[peerId])
+			return;
+
+		m_sessions[peerId]->UpdateInfo(peerInfo);
 	}
 
 	void ServerApplication::HandlePeerPacket(std::size_t peerId, Nz::NetPacket&& packet)
 	{
 		//std::cout << "Client #" << peerId << " sent packet of size " << packet.GetDataSize() << std::endl;
 
+		// Ignore packets sent by a peer which is being redirected
+		if (peerId >= m_sessions.size() || !m_sessions[peerId])
+			return;
+
 		if (!m_commandStore.UnserializePacket(*m_sessions[peerId], std::move(packet)))
 			m_sessions[peerId]->Disconnect();
 	}
@@ -205,8 +328,14 @@ namespace ewn
 		m_globalDatabase->SpawnWorkers(workerCount);
 	}
 
-	void ServerApplication::OnConfigLoaded(const ConfigFile& config)
+	bool ServerApplication::OnConfigLoaded(const ConfigFile& config)
 	{
+		if (m_config.GetIntegerOption<Nz::UInt32>("Game.MinStateBandwidth") > m_config.GetIntegerOption<Nz::UInt32>("Game.MaxStateBandwidth"))
+		{
+			std::cerr << "Game.MinStateBandwidth must not be greater than Game.MaxStateBandwidth" << std::endl;
+			return false;
+		}
+
 		const std::string& dbHost = m_config.GetStringOption("Database.Host");
 		const std::string& dbUser = m_config.GetStringOption("Database.Username");
 		const std::string& dbPassword = m_config.GetStringOption("Database.Password");
@@ -215,20 +344,86 @@ namespace ewn
 		std::size_t dbWorkerCount = m_config.GetIntegerOption<std::size_t>("Database.WorkerCount");
 
 		std::size_t gameWorkerCount = m_config.GetIntegerOption<std::size_t>("Game.WorkerCount");
+		unsigned int tickRate = m_config.GetIntegerOption<unsigned int>("Game.TickRate");
+
+		// Don't try to catch up more than a few ticks behind, just drop them
+		constexpr unsigned int MaxCatchUpTicks = 5;
+
+		m_tickScheduler.emplace(tickRate, MaxCatchUpTicks);
 
 		InitGameWorkers(gameWorkerCount);
 		InitGlobalDatabase(dbWorkerCount, dbHost, dbPort, dbUser, dbPassword, dbName);
+
+		return true;
 	}
 
-	bool ServerApplication::SetupNetwork(std::size_t clientPerReactor, std::size_t reactorCount, Nz::NetProtocol protocol, Nz::UInt16 firstPort)
+	bool ServerApplication::RedirectPeer(std::size_t peerId, std::size_t sessionId, std::size_t reactorId)
 	{
-		m_peerPerReactor = clientPerReactor;
+		// Clients have a few seconds to reconnect on their reactor
+		constexpr Nz::UInt64 RedirectionTimeout = 10'000;
+
+		Nz::UInt64 now = GetAppTime();
+		for (auto it = m_pendingRedirects.begin(); it != m_pendingRedirects.end();)
+		{
+			if (now > it->second.expirationTime)
+				it = m_pendingRedirects.erase(it);
+			else
+				++it;
+		}
+
+		// Zero is the connection data of a fresh client
+		SecureRandomGenerator gen;
+
+		Nz::UInt32 token = 0;
+		while (token == 0 || m_pendingRedirects.find(token) != m_pendingRedirects.end())
+		{
+			if (!gen(&token, sizeof(token)))
+			{
+				std::cerr << "SecureRandomGenerator failed, client #" << peerId << " won't be redirected" << std::endl;
+				return false;
+			}
+		}
+
+		PendingRedirect& redirect = m_pendingRedirects[token];
+		redirect.expirationTime = now + RedirectionTimeout;
+		redirect.reactorId = reactorId;
+		redirect.sessionId = sessionId;
+
+		Packets::ConnectionRedirect redirectPacket;
+		redirectPacket.port = Nz::UInt16(m_firstPort + reactorId);
+		redirectPacket.token = token;
+
+		const auto& command = m_commandStore.GetOutgoingCommand<Packets::ConnectionRedirect>();
+
+		Nz::NetPacket packet;
+		m_commandStore.SerializePacket(packet, redirectPacket);
+
+		// Disconnect once the redirection packet has been received
+		const std::unique_ptr<NetworkReactor>& reactor = GetReactor(peerId / GetPeerPerReactor());
+		reactor->SendData(peerId, command.channelId, command.flags, std::move(packet));
+		reactor->DisconnectPeer(peerId, 0, DisconnectionType::Later);
+
+		return true;
+	}
+
+	bool ServerApplication::SetupNetwork(std::size_t maxClients, std::size_t reactorCount, Nz::NetProtocol protocol, Nz::UInt16 firstPort)
+	{
+		// Peers are spread evenly over reactors, round up so there's always room for maxClients of them
+		m_firstPort = firstPort;
+		m_peerPerReactor = (maxClients + reactorCount - 1) / reactorCount;
+
+		// Keep each reactor on its own core to prevent them from fighting over the same cache
+		bool pinReactors = m_config.GetBoolOption("Game.PinReactorThreads");
+		std::size_t coreCount = std::max(std::thread::hardware_concurrency(), 1U);
 
 		ClearReactors();
 		try
 		{
 			for (std::size_t i = 0; i < reactorCount; ++i)
-				AddReactor(std::make_unique<NetworkReactor>(m_peerPerReactor * i, protocol, Nz::UInt16(firstPort + i), clientPerReactor));
+			{
+				std::size_t coreAffinity = (pinReactors) ? i % coreCount : NetworkReactor::NoCoreAffinity;
+				AddReactor(std::make_unique<NetworkReactor>(m_peerPerReactor * i, protocol, Nz::UInt16(firstPort + i), m_peerPerReactor, coreAffinity));
+			}
 
 			return true;
 		}
@@ -257,8 +452,19 @@ namespace ewn
 		m_config.RegisterIntegerOption("Security.HashLength");
 		m_config.RegisterStringOption("Security.PasswordSalt");
 
-		m_config.RegisterIntegerOption("Game.MaxClients", 0, 4096); //< 4096 due to ENet limitation
+		m_config.RegisterBoolOption("Game.ArenaThreads");
+		m_config.RegisterFloatOption("Game.BroadphaseCellSize", 1.0, 1'000'000.0);
+		m_config.RegisterFloatOption("Game.InterestRadius", 1.0, 1'000'000.0);
+		m_config.RegisterIntegerOption("Game.MaxClients", 0, 4096); //< total over all reactors, 4096 due to ENet limitation
+		m_config.RegisterFloatOption("Game.MaxCommunicationRange", 1.0, 1'000'000.0);
+		m_config.RegisterIntegerOption("Game.MaxStateBandwidth", 1024, 100 * 1024 * 1024);
+		m_config.RegisterIntegerOption("Game.MinStateBandwidth", 1024, 100 * 1024 * 1024);
+		m_config.RegisterBoolOption("Game.PinReactorThreads");
 		m_config.RegisterIntegerOption("Game.Port", 1, 0xFFFF);
+		m_config.RegisterIntegerOption("Game.ReactorCount", 1, 64);
+		m_config.RegisterIntegerOption("Game.ScriptStatsInterval", 0, 86'400); //< in seconds, 0 disables periodic script stats
+		m_config.RegisterIntegerOption("Game.ScriptWorkerCount", 0, 64); //< 0 runs scripts on the arena thread
+		m_config.RegisterIntegerOption("Game.TickRate", 1, 1000);
 		m_config.RegisterIntegerOption("Game.WorkerCount", 1, 100);
 
 		m_config.RegisterStringOption("DefaultSpaceship.Hull");
@@ -269,13 +475,43 @@ namespace ewn
 
 	void ServerApplication::RegisterNetworkedStrings()
 	{
+		m_stringStore.RegisterString("ball");
 		m_stringStore.RegisterString("earth");
 		m_stringStore.RegisterString("light");
 		m_stringStore.RegisterString("plasmabeam");
+		m_stringStore.RegisterString("spaceship");
 		m_stringStore.RegisterString("torpedo");
 		m_stringStore.RegisterString("explosion_flare");
 		m_stringStore.RegisterString("explosion_fire");
 		m_stringStore.RegisterString("explosion_smoke");
 		m_stringStore.RegisterString("explosion_wave");
 	}
+
+	void ServerApplication::UpdateTickBudget(Nz::UInt64 now, Nz::UInt64 tickTime)
+	{
+		constexpr Nz::UInt64 ReportInterval = 10'000'000;
+
+		if (tickTime > m_tickScheduler->GetTickDurationMicroseconds())
+		{
+			m_overBudgetTickCount++;
+			if (tickTime > m_worstTickTime)
+			{
+				m_worstTickTime = tickTime;
+				m_worstTickTimings = m_lastTickTimings;
+			}
+		}
+
+		if (now - m_lastTickBudgetReport < ReportInterval)
+			return;
+
+		if (m_overBudgetTickCount > 0)
+		{
+			std::cout << "Server is running late: " << m_overBudgetTickCount << " tick(s) over budget in the last " << ReportInterval / 1'000'000 << "s (worst: " << m_worstTickTime / 1'000.f << "ms, budget: " << m_tickScheduler->GetTickDurationMicroseconds() / 1'000.f << "ms)" << std::endl;
+			std::cout << "Worst tick: world update " << m_worstTickTimings.worldUpdate << "us (" << m_worstTickTimings.tickCount << " tick(s)), database " << m_worstTickTimings.databasePoll << "us, callbacks " << m_worstTickTimings.callbacks << "us, network " << m_worstTickTimings.network << "us" << std::endl;
+		}
+
+		m_lastTickBudgetReport = now;
+		m_overBudgetTickCount = 0;
+		m_worstTickTime = 0;
+	}
 }
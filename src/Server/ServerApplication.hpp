@@ -11,10 +11,12 @@
 #include <Shared/Protocol/NetworkStringStore.hpp>
 #include <Nazara/Core/MemoryPool.hpp>
 #include <Server/Arena.hpp>
+#include <Server/ArenaWorker.hpp>
 #include <Server/GameWorker.hpp>
 #include <Server/GlobalDatabase.hpp>
 #include <Server/ServerCommandStore.hpp>
 #include <Server/ServerChatCommandStore.hpp>
+#include <Server/TickScheduler.hpp>
 #include <Server/Store/CollisionMeshStore.hpp>
 #include <Server/Store/ModuleStore.hpp>
 #include <Server/Store/SpaceshipHullStore.hpp>
@@ -30,6 +32,7 @@ namespace ewn
 
 		public:
 			struct DefaultSpaceship;
+			struct TickTimings;
 			using ServerCallback = std::function<void()>;
 			using WorkerFunction = std::function<void()>;
 
@@ -46,12 +49,15 @@ namespace ewn
 			inline const ServerChatCommandStore& GetChatCommandStore() const;
 			inline CollisionMeshStore& GetCollisionMeshStore();
 			inline const CollisionMeshStore& GetCollisionMeshStore() const;
+			inline const ServerCommandStore& GetCommandStore() const;
 			inline const DefaultSpaceship& GetDefaultSpaceshipData() const;
 			inline Database& GetGlobalDatabase();
+			inline const TickTimings& GetLastTickTimings() const;
 			inline ModuleStore& GetModuleStore();
 			inline const ModuleStore& GetModuleStore() const;
 			inline std::size_t GetPeerPerReactor() const;
 			inline Player* GetPlayerBySession(std::size_t sessionId);
+			inline LatencyHistogram& GetReactorSendLatency(std::size_t reactorId);
 			inline const NetworkStringStore& GetNetworkStringStore() const;
 			inline SpaceshipHullStore& GetSpaceshipHullStore();
 			inline const SpaceshipHullStore& GetSpaceshipHullStore() const;
@@ -64,7 +70,7 @@ namespace ewn
 
 			inline void RegisterCallback(ServerCallback callback);
 
-			bool SetupNetwork(std::size_t clientPerReactor, std::size_t reactorCount, Nz::NetProtocol protocol, Nz::UInt16 firstPort);
+			bool SetupNetwork(std::size_t maxClients, std::size_t reactorCount, Nz::NetProtocol protocol, Nz::UInt16 firstPort);
 
 			struct DefaultSpaceship
 			{
@@ -74,33 +80,59 @@ namespace ewn
 				std::vector<std::size_t> moduleIds;
 			};
 
+			struct TickTimings
+			{
+				// All durations are in microseconds
+				Nz::UInt64 callbacks;
+				Nz::UInt64 databasePoll;
+				Nz::UInt64 network;
+				Nz::UInt64 worldUpdate;
+				unsigned int tickCount;
+			};
+
 		private:
 			using CallbackQueue = moodycamel::ConcurrentQueue<ServerCallback>;
 			using WorkerQueue = moodycamel::BlockingConcurrentQueue<WorkerFunction>;
 
+			struct PendingRedirect
+			{
+				std::size_t reactorId;
+				std::size_t sessionId;
+				Nz::UInt64 expirationTime;
+			};
+
 			bool BakeDefaultSpaceshipData();
 
 			inline WorkerQueue& GetWorkerQueue();
 
 			void HandlePeerConnection(bool outgoing, std::size_t peerId, Nz::UInt32 data) override;
 			void HandlePeerDisconnection(std::size_t peerId, Nz::UInt32 data) override;
+			void HandlePeerInfo(std::size_t peerId, const NetworkReactor::PeerInfo& peerInfo) override;
 			void HandlePeerPacket(std::size_t peerId, Nz::NetPacket&& packet) override;
 
 			void InitGameWorkers(std::size_t workerCount);
 			void InitGlobalDatabase(std::size_t workerCount, std::string dbHost, Nz::UInt16 port, std::string dbUser, std::string dbPassword, std::string dbName);
 
-			void OnConfigLoaded(const ConfigFile& config) override;
+			bool OnConfigLoaded(const ConfigFile& config) override;
+
+			bool RedirectPeer(std::size_t peerId, std::size_t sessionId, std::size_t reactorId);
 
 			void RegisterConfigOptions();
 			void RegisterNetworkedStrings();
 
+			void UpdateTickBudget(Nz::UInt64 now, Nz::UInt64 tickTime);
+
 			std::optional<GlobalDatabase> m_globalDatabase;
+			std::optional<TickScheduler> m_tickScheduler;
+			std::size_t m_overBudgetTickCount;
 			std::size_t m_peerPerReactor;
 			std::size_t m_nextSessionId;
 			std::unordered_map<std::size_t /*sessionId*/, std::size_t /*peerId*/> m_sessionIdToPeer;
+			std::unordered_map<Nz::UInt32 /*token*/, PendingRedirect> m_pendingRedirects;
 			std::vector<std::unique_ptr<GameWorker>> m_workers;
 			std::vector<ClientSession*> m_sessions;
 			std::vector<std::unique_ptr<Arena>> m_arenas;
+			std::vector<std::unique_ptr<ArenaWorker>> m_arenaWorkers; //< Must be destroyed before arenas
 			Nz::MemoryPool m_sessionPool;
 			CallbackQueue m_callbackQueue;
 			CollisionMeshStore m_collisionMeshStore;
@@ -110,8 +142,14 @@ namespace ewn
 			ServerChatCommandStore m_chatCommandStore;
 			ServerCommandStore m_commandStore;
 			SpaceshipHullStore m_spaceshipHullStore;
+			TickTimings m_lastTickTimings;
+			TickTimings m_worstTickTimings;
 			VisualMeshStore m_visualMeshStore;
 			WorkerQueue m_workerQueue;
+			Nz::UInt64 m_lastPeerInfoQuery;
+			Nz::UInt64 m_lastTickBudgetReport;
+			Nz::UInt64 m_worstTickTime;
+			Nz::UInt16 m_firstPort;
 	};
 }
 
@@ -48,11 +48,21 @@ namespace ewn
 		return m_collisionMeshStore;
 	}
 
+	inline const ServerCommandStore& ServerApplication::GetCommandStore() const
+	{
+		return m_commandStore;
+	}
+
 	inline const ServerApplication::DefaultSpaceship& ServerApplication::GetDefaultSpaceshipData() const
 	{
 		return m_defaultSpaceshipData;
 	}
 
+	inline const ServerApplication::TickTimings& ServerApplication::GetLastTickTimings() const
+	{
+		return m_lastTickTimings;
+	}
+
 	inline ModuleStore& ServerApplication::GetModuleStore()
 	{
 		return m_moduleStore;
@@ -77,6 +87,11 @@ namespace ewn
 			return nullptr;
 	}
 
+	inline LatencyHistogram& ServerApplication::GetReactorSendLatency(std::size_t reactorId)
+	{
+		return GetReactor(reactorId)->GetSendLatency();
+	}
+
 	inline const NetworkStringStore& ServerApplication::GetNetworkStringStore() const
 	{
 		return m_stringStore;
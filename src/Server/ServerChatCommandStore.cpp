@@ -34,9 +34,11 @@ namespace ewn
 		RegisterCommand("debugparticles", &ServerChatCommandStore::HandleDebugParticles);
 		RegisterCommand("kamikaze", &ServerChatCommandStore::HandleSuicide);
 		RegisterCommand("kick", &ServerChatCommandStore::HandleKickPlayer);
+		RegisterCommand("netstats", &ServerChatCommandStore::HandleNetworkStats);
 		RegisterCommand("reloadarena", &ServerChatCommandStore::HandleReloadArena);
 		RegisterCommand("reloadmodules", &ServerChatCommandStore::HandleReloadModules);
 		RegisterCommand("resetarena", &ServerChatCommandStore::HandleResetArena);
+		RegisterCommand("scriptstats", &ServerChatCommandStore::HandleScriptStats, std::size_t(5));
 		RegisterCommand("spawnfleet", &ServerChatCommandStore::HandleSpawnFleet);
 		RegisterCommand("stopserver", &ServerChatCommandStore::HandleStopServer);
 		RegisterCommand("suicide", &ServerChatCommandStore::HandleSuicide);
@@ -96,6 +98,27 @@ namespace ewn
 		return true;
 	}
 
+	bool ServerChatCommandStore::HandleNetworkStats(ServerApplication* app, Player* player)
+	{
+		if (player->GetPermissionLevel() < 20)
+			return false;
+
+		// Histograms are reset so each call reports what happened since the previous one
+		for (std::size_t i = 0; i < app->GetReactorCount(); ++i)
+		{
+			LatencyHistogram& sendLatency = app->GetReactorSendLatency(i);
+
+			player->PrintMessage("Reactor #" + std::to_string(i) + ": " + std::to_string(sendLatency.GetSampleCount()) + " packet(s) sent, enqueue to wire: "
+			                     "p50 <= " + std::to_string(sendLatency.GetPercentile(0.5f)) + "us, "
+			                     "p99 <= " + std::to_string(sendLatency.GetPercentile(0.99f)) + "us, "
+			                     "max " + std::to_string(sendLatency.GetMaximum()) + "us");
+
+			sendLatency.Reset();
+		}
+
+		return true;
+	}
+
 	bool ServerChatCommandStore::HandleReloadArena(ServerApplication * app, Player * player)
 	{
 		if (player->GetPermissionLevel() < 30)
@@ -112,13 +135,21 @@ namespace ewn
 		if (player->GetPermissionLevel() < 30)
 			return false;
 
-		ModuleStore& moduleStore = app->GetModuleStore();
-		moduleStore.LoadFromDatabase(app, app->GetGlobalDatabase(), [ply = player->CreateHandle()](bool updateSucceeded)
+		// Module store is shared by all arenas, reload it from the main thread
+		app->RegisterCallback([app, sessionId = player->GetSessionId()]()
 		{
-			if (updateSucceeded)
-				ply->PrintMessage("Module reloaded");
-			else
-				ply->PrintMessage("Failed to reload modules");
+			ModuleStore& moduleStore = app->GetModuleStore();
+			moduleStore.LoadFromDatabase(app, app->GetGlobalDatabase(), [app, sessionId](bool updateSucceeded)
+			{
+				Player* ply = app->GetPlayerBySession(sessionId);
+				if (!ply)
+					return;
+
+				if (updateSucceeded)
+					ply->PrintMessage("Module reloaded");
+				else
+					ply->PrintMessage("Failed to reload modules");
+			});
 		});
 
 		return true;
@@ -135,6 +166,21 @@ namespace ewn
 		return true;
 	}
 
+	bool ServerChatCommandStore::HandleScriptStats(ServerApplication* /*app*/, Player* player, std::size_t maxOwnerCount)
+	{
+		if (player->GetPermissionLevel() < 20)
+			return false;
+
+		// Script counters are reset so each call reports what happened since the previous one
+		if (Arena* arena = player->GetArena())
+		{
+			for (const std::string& line : arena->BuildScriptStatsReport(maxOwnerCount))
+				player->PrintMessage(line);
+		}
+
+		return true;
+	}
+
 	bool ServerChatCommandStore::HandleSpawnFleet(ServerApplication* app, Player* player, std::string fleetName)
 	{
 		//if (player->GetPermissionLevel() < 40)
@@ -182,11 +228,12 @@ namespace ewn
 			std::string code = std::get<std::string>(result.GetValue(1));
 			Nz::Int32 spaceshipHullId = std::get<Nz::Int32>(result.GetValue(2));
 
-			app->GetGlobalDatabase().ExecuteStatement("FindSpaceshipModulesBySpaceshipId", { spaceshipId }, [app, ply, spaceshipHullId, spaceshipCount, shipName = std::move(spaceshipName), spaceshipCode = std::move(code)](DatabaseResult& result)
+			app->GetGlobalDatabase().ExecuteStatement("FindSpaceshipModulesBySpaceshipId", { spaceshipId }, [app, sessionId, spaceshipHullId, spaceshipCount, shipName = std::move(spaceshipName), spaceshipCode = std::move(code)](DatabaseResult& result)
 			{
 				if (!result)
 					std::cerr << "Find spaceship modules failed: " << result.GetLastErrorMessage() << std::endl;
 
+				Player* ply = app->GetPlayerBySession(sessionId);
 				if (!ply)
 					return;
 
@@ -212,22 +259,25 @@ namespace ewn
 					return;
 				}
 
-				for (std::size_t i = 0; i < spaceshipCount; ++i)
+				ply->PostArenaCommand([app, ply, spaceshipHullId, spaceshipCount, shipName, spaceshipCode, moduleIds = std::move(moduleIds)]()
 				{
-					const Ndk::EntityHandle& playerBot = ply->InstantiateBot(shipName, spaceshipHullId, float(i) * Nz::Vector3f::Right() * 10.f);
-					ScriptComponent& botScript = playerBot->AddComponent<ScriptComponent>();
-					if (!botScript.Initialize(app, moduleIds))
+					for (std::size_t i = 0; i < spaceshipCount; ++i)
 					{
-						ply->PrintMessage("Failed to initialize bot #" + std::to_string(i) + ", please contact an administrator");
-						return;
+						const Ndk::EntityHandle& playerBot = ply->InstantiateBot(shipName, spaceshipHullId, float(i) * Nz::Vector3f::Right() * 10.f);
+						ScriptComponent& botScript = playerBot->AddComponent<ScriptComponent>();
+						if (!botScript.Initialize(app, moduleIds))
+						{
+							ply->PrintMessage("Failed to initialize bot #" + std::to_string(i) + ", please contact an administrator");
+							return;
+						}
+
+						Nz::String lastError;
+						if (!botScript.Execute(spaceshipCode, &lastError))
+							ply->PrintMessage("Failed to execute script for bot #" + std::to_string(i) + ": " + lastError.ToStdString());
 					}
 
-					Nz::String lastError;
-					if (!botScript.Execute(spaceshipCode, &lastError))
-						ply->PrintMessage("Failed to execute script for bot #" + std::to_string(i) + ": " + lastError.ToStdString());
-				}
-
-				ply->PrintMessage("Bot(s) loaded with success");
+					ply->PrintMessage("Bot(s) loaded with success");
+				});
 			});
 		});
 
@@ -250,7 +300,11 @@ namespace ewn
 		if (player->GetPermissionLevel() < 40)
 			return false;
 
-		app->Quit();
+		app->RegisterCallback([app]()
+		{
+			app->Quit();
+		});
+
 		return true;
 	}
 
@@ -268,15 +322,24 @@ namespace ewn
 			return false;
 		}
 
-		target->UpdatePermissionLevel(permissionLevel, [ply = player->CreateHandle()](bool success)
+		// Permission level is read from the main thread, update it from there
+		app->RegisterCallback([app, permissionLevel, sessionId = player->GetSessionId(), targetSessionId = target->GetSessionId()]()
 		{
-			if (!ply)
+			Player* targetPlayer = app->GetPlayerBySession(targetSessionId);
+			if (!targetPlayer)
 				return;
 
-			if (success)
-				ply->PrintMessage("Permission level was successfully updated");
-			else
-				ply->PrintMessage("Failed to update permission level in database, changes are local");
+			targetPlayer->UpdatePermissionLevel(permissionLevel, [app, sessionId](bool success)
+			{
+				Player* ply = app->GetPlayerBySession(sessionId);
+				if (!ply)
+					return;
+
+				if (success)
+					ply->PrintMessage("Permission level was successfully updated");
+				else
+					ply->PrintMessage("Failed to update permission level in database, changes are local");
+			});
 		});
 
 		return false;
@@ -27,9 +27,11 @@ namespace ewn
 			static bool HandleCrashServer(ServerApplication* app, Player* player);
 			static bool HandleDebugParticles(ServerApplication* app, Player* player, unsigned int particleSystemId);
 			static bool HandleKickPlayer(ServerApplication* app, Player* player, Player* target);
+			static bool HandleNetworkStats(ServerApplication* app, Player* player);
 			static bool HandleReloadArena(ServerApplication* app, Player* player);
 			static bool HandleReloadModules(ServerApplication* app, Player* player);
 			static bool HandleResetArena(ServerApplication* app, Player* player);
+			static bool HandleScriptStats(ServerApplication* app, Player* player, std::size_t maxOwnerCount);
 			static bool HandleSpawnBot(ServerApplication* app, Player* player, std::string spaceshipName, std::size_t spaceshipCount);
 			static bool HandleSpawnFleet(ServerApplication* app, Player* player, std::string fleetName);
 			static bool HandleSuicide(ServerApplication* app, Player* player);
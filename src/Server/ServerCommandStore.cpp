@@ -16,6 +16,7 @@ namespace ewn
 #define OutgoingCommand(Type, Flags, Channel) RegisterOutgoingCommand<Packets::Type>(#Type, Flags, Channel)
 
 		// Incoming commands
+		IncomingCommand(ArenaStateAck);
 		IncomingCommand(ControlEntity);
 		IncomingCommand(CreateFleet);
 		IncomingCommand(CreateSpaceship);
@@ -48,13 +49,12 @@ namespace ewn
 		OutgoingCommand(ArenaState,                0,                           1);
 		OutgoingCommand(BotMessage,                Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(ChatMessage,               Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(ConnectionRedirect,        Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(ControlEntity,             Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(CreateEntities,            Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(CreateFleetFailure,        Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(CreateFleetSuccess,        Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(CreateSpaceshipFailure,    Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(CreateSpaceshipSuccess,    Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(DeleteEntities,            Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(DeleteFleetFailure,        Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(DeleteFleetSuccess,        Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(DeleteSpaceshipFailure,    Nz::ENetPacketFlag_Reliable, 0);
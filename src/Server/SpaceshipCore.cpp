@@ -4,9 +4,16 @@
 
 #include <Server/SpaceshipCore.hpp>
 #include <NDK/Components/PhysicsComponent3D.hpp>
+#include <Shared/Utils.hpp>
 #include <Server/SpaceshipModule.hpp>
 #include <Server/Components/HealthComponent.hpp>
 #include <Server/Components/SignatureComponent.hpp>
+#include <Server/Modules/CommunicationsModule.hpp>
+#include <Server/Modules/EngineModule.hpp>
+#include <Server/Modules/NavigationModule.hpp>
+#include <Server/Modules/RadarModule.hpp>
+#include <Server/Modules/WeaponModule.hpp>
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -67,40 +74,87 @@ namespace ewn
 		return signatureComponent.GetSignature();
 	}
 
-	void SpaceshipCore::Register(Nz::LuaState& lua)
+	void SpaceshipCore::ProcessCommands()
 	{
-		if (!s_binding)
-		{
-			s_binding.emplace("Core");
+		for (const Command& command : m_pendingCommands)
+			command();
 
-			s_binding->BindMethod("GetAngularVelocity", &SpaceshipCore::GetAngularVelocity);
-			s_binding->BindMethod("GetIntegrity",       &SpaceshipCore::GetIntegrity);
-			s_binding->BindMethod("GetLinearVelocity",  &SpaceshipCore::GetLinearVelocity);
-			s_binding->BindMethod("GetPosition",        &SpaceshipCore::GetPosition);
-			s_binding->BindMethod("GetRotation",        &SpaceshipCore::GetRotation);
-			s_binding->BindMethod("GetSignature",       &SpaceshipCore::GetSignature);
+		m_pendingCommands.clear();
+	}
 
-			s_binding->BindMethod("GetModules", [](Nz::LuaState& state, SpaceshipCore* core, std::size_t /*argCount*/) -> int
+	unsigned int SpaceshipCore::PushCallbackArgs(Nz::LuaState& lua, const CallbackArgs& args)
+	{
+		return std::visit([&](auto&& arg) -> unsigned int
+		{
+			using T = std::decay_t<decltype(arg)>;
+
+			if constexpr (std::is_same_v<T, std::monostate>)
+				return 0;
+			else if constexpr (std::is_same_v<T, float>)
 			{
-				constexpr std::size_t moduleCount = static_cast<std::size_t>(ModuleType::Max) + 1;
+				lua.Push(arg);
+				return 1;
+			}
+			else if constexpr (std::is_same_v<T, RadarObjectArgs>)
+			{
+				lua.Push(arg.signature);
+				lua.Push(arg.emSignature);
+				lua.Push(arg.radius);
+				lua.Push(LuaVec3(arg.direction));
+				lua.Push(arg.distance);
+				return 5;
+			}
+			else if constexpr (std::is_same_v<T, CallbackArgFunction>)
+				return static_cast<unsigned int>(arg(lua));
+			else
+				static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
+		}, args);
+	}
+
+	bool SpaceshipCore::Initialize()
+	{
+		// Bindings are shared by every bot Lua state of every arena, build them before any arena thread starts
+		s_binding.emplace("Core");
+
+		s_binding->BindMethod("GetAngularVelocity", &SpaceshipCore::GetAngularVelocity);
+		s_binding->BindMethod("GetIntegrity",       &SpaceshipCore::GetIntegrity);
+		s_binding->BindMethod("GetLinearVelocity",  &SpaceshipCore::GetLinearVelocity);
+		s_binding->BindMethod("GetPosition",        &SpaceshipCore::GetPosition);
+		s_binding->BindMethod("GetRotation",        &SpaceshipCore::GetRotation);
+		s_binding->BindMethod("GetSignature",       &SpaceshipCore::GetSignature);
 
-				state.PushTable(0, moduleCount);
+		s_binding->BindMethod("GetModules", [](Nz::LuaState& state, SpaceshipCore* core, std::size_t /*argCount*/) -> int
+		{
+			constexpr std::size_t moduleCount = static_cast<std::size_t>(ModuleType::Max) + 1;
 
-				std::size_t index = 1;
-				for (std::size_t i = 0; i < moduleCount; ++i)
+			state.PushTable(0, moduleCount);
+
+			std::size_t index = 1;
+			for (std::size_t i = 0; i < moduleCount; ++i)
+			{
+				if (SpaceshipModule* modulePtr = core->GetModule<SpaceshipModule>(static_cast<ModuleType>(i)))
 				{
-					if (SpaceshipModule* modulePtr = core->GetModule<SpaceshipModule>(static_cast<ModuleType>(i)))
-					{
-						state.Push(index++);
-						modulePtr->PushInstance(state);
-						state.SetTable();
-					}
+					state.Push(index++);
+					modulePtr->PushInstance(state);
+					state.SetTable();
 				}
+			}
 
-				return 1;
-			});
-		}
+			return 1;
+		});
+
+		Nz::LuaClass<SpaceshipModule>& parentBinding = SpaceshipModule::BindParent();
+		CommunicationsModule::BindModule(parentBinding);
+		EngineModule::BindModule(parentBinding);
+		NavigationModule::BindModule(parentBinding);
+		RadarModule::BindModule(parentBinding);
+		WeaponModule::BindModule(parentBinding);
+
+		return true;
+	}
 
+	void SpaceshipCore::Register(Nz::LuaState& lua)
+	{
 		s_binding->Register(lua);
 
 		SpaceshipModule::RegisterParent(lua);
@@ -120,5 +174,25 @@ namespace ewn
 			modulePtr->Run(elapsedTime);
 	}
 
+	void SpaceshipCore::Uninitialize()
+	{
+		WeaponModule::UnbindModule();
+		RadarModule::UnbindModule();
+		NavigationModule::UnbindModule();
+		EngineModule::UnbindModule();
+		CommunicationsModule::UnbindModule();
+		SpaceshipModule::UnbindParent();
+
+		s_binding.reset();
+	}
+
 	std::optional<Nz::LuaClass<SpaceshipCoreHandle>> SpaceshipCore::s_binding;
+	// Indexed by callback id, names never change once the server is running
+	const std::array<std::string, SpaceshipCore::CallbackCount> SpaceshipCore::s_callbackNames = {
+		"OnStart",
+		"OnTick",
+		"OnCommunicationReceivedMessages",
+		"OnNavigationDestinationReached",
+		"OnRadarNewObjectInRange"
+	};
 }
@@ -13,9 +13,11 @@
 #include <NDK/Entity.hpp>
 #include <Shared/Enums.hpp>
 #include <Server/Scripting/LuaMathTypes.hpp>
+#include <array>
 #include <functional>
 #include <optional>
-#include <unordered_map>
+#include <string>
+#include <variant>
 #include <vector>
 
 namespace ewn
@@ -29,7 +31,19 @@ namespace ewn
 	class SpaceshipCore : public Nz::HandledObject<SpaceshipCore>
 	{
 		public:
+			struct RadarObjectArgs
+			{
+				Nz::Int64 signature;
+				Nz::Vector3f direction;
+				double emSignature;
+				double radius;
+				float distance;
+			};
+
 			using CallbackArgFunction = std::function<int(Nz::LuaState& state)>;
+			using CallbackArgs = std::variant<std::monostate, float, RadarObjectArgs, CallbackArgFunction>; //< Use CallbackArgFunction only for payloads which allocate anyway
+			using CallbackId = std::size_t;
+			using Command = std::function<void()>;
 
 			inline SpaceshipCore(ServerApplication* app, const Ndk::EntityHandle& spaceship);
 			SpaceshipCore(const SpaceshipCore&) = delete;
@@ -40,12 +54,15 @@ namespace ewn
 
 			inline ServerApplication* GetApp();
 
+			inline void PostCommand(Command command);
+			void ProcessCommands();
+
 			void Register(Nz::LuaState& lua);
 			void Run(float elapsedTime);
 
-			inline void PushCallback(std::string callbackName, CallbackArgFunction argFunc = nullptr, bool unique = true);
-			inline void PushCallback(Nz::UInt64 triggerTime, std::string callbackName, CallbackArgFunction argFunc = nullptr, bool unique = true);
-			inline std::optional<std::pair<std::string, CallbackArgFunction>> PopCallback();
+			inline void PushCallback(CallbackId callbackId, CallbackArgs args = {}, bool unique = true);
+			inline void PushCallback(Nz::UInt64 triggerTime, CallbackId callbackId, CallbackArgs args = {}, bool unique = true);
+			inline std::optional<std::pair<CallbackId, CallbackArgs>> PopCallback();
 
 			// Lua API
 			LuaVec3 GetAngularVelocity() const;
@@ -57,22 +74,42 @@ namespace ewn
 
 			SpaceshipCore& operator=(const SpaceshipCore&) = delete;
 
+			static inline const std::string& GetCallbackName(CallbackId callbackId);
+			static bool Initialize();
+			static unsigned int PushCallbackArgs(Nz::LuaState& lua, const CallbackArgs& args);
+			static void Uninitialize();
+
+			static constexpr CallbackId OnStartCallback = 0;
+			static constexpr CallbackId OnTickCallback = 1;
+			static constexpr CallbackId OnCommunicationReceivedMessagesCallback = 2;
+			static constexpr CallbackId OnNavigationDestinationReachedCallback = 3;
+			static constexpr CallbackId OnRadarNewObjectInRangeCallback = 4;
+			static constexpr std::size_t CallbackCount = 5;
+
 		private:
 			struct Callback
 			{
 				Nz::UInt64 triggerTime;
-				std::string callbackName;
-				CallbackArgFunction argFunc;
+				Nz::UInt64 sequence;
+				CallbackId callbackId;
+				CallbackArgs args;
 			};
 
-			std::unordered_map<std::string, bool> m_pushedCallbacks;
+			static inline bool CompareCallbacks(const Callback& lhs, const Callback& rhs);
+
+			static constexpr std::size_t CallbackQueueCapacity = 32;
+
+			std::array<bool, CallbackCount> m_pushedCallbacks;
 			std::vector<std::shared_ptr<SpaceshipModule>> m_modules;
 			std::vector<std::shared_ptr<SpaceshipModule>> m_runnableModules;
 			std::vector<Callback> m_callbacks;
+			std::vector<Command> m_pendingCommands;
 			Ndk::EntityHandle m_spaceship;
 			ServerApplication* m_app;
+			Nz::UInt64 m_callbackSequence;
 
 			static std::optional<Nz::LuaClass<SpaceshipCoreHandle>> s_binding;
+			static const std::array<std::string, CallbackCount> s_callbackNames;
 	};
 }
 
@@ -4,14 +4,18 @@
 
 #include <Server/SpaceshipCore.hpp>
 #include <Server/ServerApplication.hpp>
+#include <algorithm>
 #include <cassert>
 
 namespace ewn
 {
 	inline SpaceshipCore::SpaceshipCore(ServerApplication* app, const Ndk::EntityHandle& spaceship) :
 	m_spaceship(spaceship),
-	m_app(app)
+	m_app(app),
+	m_callbackSequence(0)
 	{
+		m_callbacks.reserve(CallbackQueueCapacity);
+		m_pushedCallbacks.fill(false);
 	}
 
 	template<typename T>
@@ -32,75 +36,84 @@ namespace ewn
 		return m_app;
 	}
 
-	inline void SpaceshipCore::PushCallback(std::string callbackName, CallbackArgFunction argFunc, bool unique)
+	inline void SpaceshipCore::PostCommand(Command command)
 	{
-		PushCallback(m_app->GetAppTime(), std::move(callbackName), std::move(argFunc), unique);
+		m_pendingCommands.emplace_back(std::move(command));
 	}
 
-	inline void SpaceshipCore::PushCallback(Nz::UInt64 triggerTime, std::string callbackName, CallbackArgFunction argFunc, bool unique)
+	inline void SpaceshipCore::PushCallback(CallbackId callbackId, CallbackArgs args, bool unique)
 	{
-		auto SortCallbacks = [](const Callback& lhs, const Callback& rhs)
-		{
-			return lhs.triggerTime > rhs.triggerTime;
-		};
+		PushCallback(m_app->GetAppTime(), callbackId, std::move(args), unique);
+	}
 
+	inline void SpaceshipCore::PushCallback(Nz::UInt64 triggerTime, CallbackId callbackId, CallbackArgs args, bool unique)
+	{
 		// Check if callback is already in the waiting queue
 		if (unique)
 		{
-			auto it = m_pushedCallbacks.find(callbackName);
-			if (it == m_pushedCallbacks.end())
-				it = m_pushedCallbacks.emplace(callbackName, true).first;
-			else if (it->second)
+			assert(callbackId < m_pushedCallbacks.size());
+			if (m_pushedCallbacks[callbackId])
 			{
-				// If callback is already present, update its trigger time and resort callback
-				for (auto callbackIt = m_callbacks.begin(); callbackIt != m_callbacks.end(); ++callbackIt)
+				// If callback is already present, update its trigger time and rebuild the heap
+				for (Callback& callback : m_callbacks)
 				{
-					if (callbackIt->callbackName == callbackName)
+					if (callback.callbackId == callbackId)
 					{
-						callbackIt->argFunc = std::move(argFunc);
-						callbackIt->triggerTime = triggerTime;
-						std::sort(m_callbacks.begin(), m_callbacks.end(), SortCallbacks);
+						callback.args = std::move(args);
+						callback.triggerTime = triggerTime;
+						std::make_heap(m_callbacks.begin(), m_callbacks.end(), CompareCallbacks);
 						return;
 					}
 				}
 			}
 			else
-				it->second = true;
+				m_pushedCallbacks[callbackId] = true;
 		}
 
 		// Insert a new callback in the queue
-		Callback callback;
-		callback.argFunc = std::move(argFunc);
-		callback.callbackName = std::move(callbackName);
+		Callback& callback = m_callbacks.emplace_back();
+		callback.args = std::move(args);
+		callback.callbackId = callbackId;
+		callback.sequence = m_callbackSequence++;
 		callback.triggerTime = triggerTime;
 
-		auto callbackIt = std::upper_bound(m_callbacks.begin(), m_callbacks.end(), callback, SortCallbacks);
-
-		m_callbacks.emplace(callbackIt, std::move(callback));
+		std::push_heap(m_callbacks.begin(), m_callbacks.end(), CompareCallbacks);
 	}
 
-	inline std::optional<std::pair<std::string, SpaceshipCore::CallbackArgFunction>> SpaceshipCore::PopCallback()
+	inline std::optional<std::pair<SpaceshipCore::CallbackId, SpaceshipCore::CallbackArgs>> SpaceshipCore::PopCallback()
 	{
 		if (m_callbacks.empty())
 			return {};
 
 		Nz::UInt64 now = m_app->GetAppTime();
-		if (m_callbacks.back().triggerTime >= now)
+		if (m_callbacks.front().triggerTime >= now)
 			return {};
 
+		std::pop_heap(m_callbacks.begin(), m_callbacks.end(), CompareCallbacks);
+
 		Callback callback = std::move(m_callbacks.back());
 		m_callbacks.pop_back();
 
-		auto it = m_pushedCallbacks.find(callback.callbackName);
-		if (it != m_pushedCallbacks.end())
-		{
-			assert(it->second);
-			it->second = false;
-		}
+		m_pushedCallbacks[callback.callbackId] = false;
 
-		//std::cout << "Executing " << callback.callbackName << " (late by " << (now - callback.triggerTime) << "ms)" << std::endl;
+		//std::cout << "Executing " << GetCallbackName(callback.callbackId) << " (late by " << (now - callback.triggerTime) << "ms)" << std::endl;
+
+		return std::make_pair(callback.callbackId, std::move(callback.args));
+	}
+
+	inline const std::string& SpaceshipCore::GetCallbackName(CallbackId callbackId)
+	{
+		assert(callbackId < s_callbackNames.size());
+		return s_callbackNames[callbackId];
+	}
+
+	inline bool SpaceshipCore::CompareCallbacks(const Callback& lhs, const Callback& rhs)
+	{
+		// Earliest trigger time on top of the heap, callbacks pushed for the same time are executed in order
+		if (lhs.triggerTime != rhs.triggerTime)
+			return lhs.triggerTime > rhs.triggerTime;
 
-		return std::make_pair(callback.callbackName, std::move(callback.argFunc));
+		return lhs.sequence > rhs.sequence;
 	}
 }
 
@@ -15,18 +15,20 @@ namespace ewn
 
 	void SpaceshipModule::Register(Nz::LuaState& lua)
 	{
-		RegisterModule(s_binding.value(), lua);
+		RegisterModule(lua);
 	}
 
-	void SpaceshipModule::RegisterParent(Nz::LuaState& lua)
+	Nz::LuaClass<SpaceshipModule>& SpaceshipModule::BindParent()
 	{
-		if (!s_binding)
-		{
-			s_binding.emplace("Module");
+		s_binding.emplace("Module");
+
+		s_binding->BindMethod("GetType", &SpaceshipModule::GetType);
 
-			s_binding->BindMethod("GetType", &SpaceshipModule::GetType);
-		}
+		return *s_binding;
+	}
 
+	void SpaceshipModule::RegisterParent(Nz::LuaState& lua)
+	{
 		s_binding->Register(lua);
 	}
 
@@ -34,5 +36,10 @@ namespace ewn
 	{
 	}
 
+	void SpaceshipModule::UnbindParent()
+	{
+		s_binding.reset();
+	}
+
 	std::optional<Nz::LuaClass<SpaceshipModule>> SpaceshipModule::s_binding;
 }
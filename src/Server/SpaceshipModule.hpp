@@ -35,7 +35,9 @@ namespace ewn
 			void Register(Nz::LuaState& lua);
 			virtual void Run(float elapsedTime);
 
+			static Nz::LuaClass<SpaceshipModule>& BindParent();
 			static void RegisterParent(Nz::LuaState& lua);
+			static void UnbindParent();
 
 			// Lua API
 			inline ModuleType GetType() const;
@@ -46,7 +48,7 @@ namespace ewn
 			inline const Ndk::EntityHandle& GetSpaceship() const;
 			template<typename... Args> void PushCallback(Args&&... args);
 
-			virtual void RegisterModule(Nz::LuaClass<SpaceshipModule>& parentBinding, Nz::LuaState& lua) = 0;
+			virtual void RegisterModule(Nz::LuaState& lua) = 0;
 
 		private:
 			Ndk::EntityHandle m_spaceship;
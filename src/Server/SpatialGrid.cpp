@@ -0,0 +1,30 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/SpatialGrid.hpp>
+
+namespace ewn
+{
+	void SpatialGrid::Clear()
+	{
+		// Keep cells memory around for the next rebuild, but drop cells which stayed empty since the last one
+		for (auto it = m_cells.begin(); it != m_cells.end();)
+		{
+			if (it->second.empty())
+				it = m_cells.erase(it);
+			else
+			{
+				it.value().clear();
+				++it;
+			}
+		}
+	}
+
+	void SpatialGrid::Insert(std::size_t id, const Nz::Vector3f& position)
+	{
+		auto& entry = m_cells[ComputeCellKey(ComputeCell(position))].emplace_back();
+		entry.id = id;
+		entry.position = position;
+	}
+}
@@ -0,0 +1,55 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_SPATIALGRID_HPP
+#define EREWHON_SERVER_SPATIALGRID_HPP
+
+#include <Nazara/Prerequisites.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <hopstotch/hopscotch_map.h>
+#include <vector>
+
+namespace ewn
+{
+	// Uniform grid hashing points in cells, rebuilt as often as needed
+	class SpatialGrid
+	{
+		public:
+			inline SpatialGrid(float cellSize);
+			SpatialGrid(const SpatialGrid&) = delete;
+			SpatialGrid(SpatialGrid&&) = default;
+			~SpatialGrid() = default;
+
+			void Clear();
+
+			template<typename F> void ForEachInSphere(const Nz::Vector3f& center, float radius, F&& callback) const;
+
+			inline float GetCellSize() const;
+
+			void Insert(std::size_t id, const Nz::Vector3f& position);
+
+			SpatialGrid& operator=(const SpatialGrid&) = delete;
+			SpatialGrid& operator=(SpatialGrid&&) = default;
+
+		private:
+			inline Nz::Vector3i ComputeCell(const Nz::Vector3f& position) const;
+			static inline Nz::UInt64 ComputeCellKey(const Nz::Vector3i& cell);
+
+			struct Entry
+			{
+				Nz::Vector3f position;
+				std::size_t id;
+			};
+
+			tsl::hopscotch_map<Nz::UInt64, std::vector<Entry>> m_cells;
+			float m_cellSize;
+			float m_invCellSize;
+	};
+}
+
+#include <Server/SpatialGrid.inl>
+
+#endif // EREWHON_SERVER_SPATIALGRID_HPP
@@ -0,0 +1,92 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/SpatialGrid.hpp>
+#include <cassert>
+#include <cmath>
+
+namespace ewn
+{
+	inline SpatialGrid::SpatialGrid(float cellSize) :
+	m_cellSize(cellSize),
+	m_invCellSize(1.f / cellSize)
+	{
+		assert(cellSize > 0.f);
+	}
+
+	template<typename F>
+	void SpatialGrid::ForEachInSphere(const Nz::Vector3f& center, float radius, F&& callback) const
+	{
+		// Also rejects NaN
+		if (!(radius >= 0.f))
+			return;
+
+		float squaredRadius = radius * radius;
+
+		// Count cells covered by the query box in double precision, so huge (or infinite) radii can't overflow
+		double boxCellCount = 1.0;
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			double minCoord = std::floor((double(center[i]) - radius) * m_invCellSize);
+			double maxCoord = std::floor((double(center[i]) + radius) * m_invCellSize);
+			boxCellCount *= maxCoord - minCoord + 1.0;
+		}
+
+		// Walking the occupied cells is cheaper than probing a box bigger than the whole grid
+		if (!(boxCellCount <= double(m_cells.size())))
+		{
+			for (const auto& pair : m_cells)
+			{
+				for (const Entry& entry : pair.second)
+				{
+					if (entry.position.SquaredDistance(center) <= squaredRadius)
+						callback(entry.id, entry.position);
+				}
+			}
+
+			return;
+		}
+
+		Nz::Vector3i minCell = ComputeCell(center - Nz::Vector3f(radius));
+		Nz::Vector3i maxCell = ComputeCell(center + Nz::Vector3f(radius));
+
+		Nz::Vector3i cell;
+		for (cell.x = minCell.x; cell.x <= maxCell.x; ++cell.x)
+		{
+			for (cell.y = minCell.y; cell.y <= maxCell.y; ++cell.y)
+			{
+				for (cell.z = minCell.z; cell.z <= maxCell.z; ++cell.z)
+				{
+					auto it = m_cells.find(ComputeCellKey(cell));
+					if (it == m_cells.end())
+						continue;
+
+					for (const Entry& entry : it->second)
+					{
+						if (entry.position.SquaredDistance(center) <= squaredRadius)
+							callback(entry.id, entry.position);
+					}
+				}
+			}
+		}
+	}
+
+	inline float SpatialGrid::GetCellSize() const
+	{
+		return m_cellSize;
+	}
+
+	inline Nz::Vector3i SpatialGrid::ComputeCell(const Nz::Vector3f& position) const
+	{
+		return Nz::Vector3i(int(std::floor(position.x * m_invCellSize)), int(std::floor(position.y * m_invCellSize)), int(std::floor(position.z * m_invCellSize)));
+	}
+
+	inline Nz::UInt64 SpatialGrid::ComputeCellKey(const Nz::Vector3i& cell)
+	{
+		// 21 bits per axis is way more than we need
+		constexpr Nz::UInt64 AxisMask = (1 << 21) - 1;
+
+		return ((Nz::UInt64(cell.x) & AxisMask) << 42) | ((Nz::UInt64(cell.y) & AxisMask) << 21) | (Nz::UInt64(cell.z) & AxisMask);
+	}
+}
@@ -9,163 +9,397 @@
 #include <NDK/Components/CollisionComponent3D.hpp>
 #include <NDK/Components/NodeComponent.hpp>
 #include <NDK/Components/PhysicsComponent3D.hpp>
+#include <Server/Player.hpp>
 #include <Server/ServerApplication.hpp>
 #include <Server/Systems/InputSystem.hpp>
+#include <algorithm>
 #include <cassert>
 
 namespace ewn
 {
 	BroadcastSystem::BroadcastSystem(ServerApplication* app) :
-	m_snapshotId(0),
-	m_app(app)
+	m_app(app),
+	m_movingEntitiesGrid(app->GetConfig().GetFloatOption<float>("Game.InterestRadius")),
+	m_interestRadius(app->GetConfig().GetFloatOption<float>("Game.InterestRadius"))
 	{
 		Requires<Ndk::NodeComponent, SynchronizedComponent>();
 		SetMaximumUpdateRate(30.f);
 		SetUpdateOrder(100);
 	}
 
-	void BroadcastSystem::OnEntityRemoved(Ndk::Entity* entity)
+	void BroadcastSystem::AddPlayer(Player* player)
 	{
-		m_movingEntities.Remove(entity);
+		assert(std::none_of(m_playerViews.begin(), m_playerViews.end(), [=](const PlayerView& view) { return view.player == player; }));
 
-		Ndk::EntityId entityId = entity->GetId();
-		if (m_createdEntities.UnboundedTest(entityId))
-			m_createdEntities.Reset(entityId);
-		else
-			m_deletedEntities.UnboundedSet(entityId);
+		// Player starts knowing nothing, relevant entities will be created on next update
+		auto& view = m_playerViews.emplace_back();
+		view.player = player;
+		view.bandwidthCredit = 0.f;
+		view.hasInterestCenter = false;
+	}
+
+	void BroadcastSystem::RemovePlayer(Player* player)
+	{
+		auto it = std::find_if(m_playerViews.begin(), m_playerViews.end(), [=](const PlayerView& view) { return view.player == player; });
+		assert(it != m_playerViews.end());
+
+		m_playerViews.erase(it);
+	}
+
+	void BroadcastSystem::ConfirmEntityRecords(PlayerView& view)
+	{
+		// Records are part of every record state since the first one they were sent in, so an acknowledged record state confirms all records sent up to it
+		std::optional<Nz::UInt16> confirmedStateId;
+		for (auto it = view.recordStateIds.rbegin(); it != view.recordStateIds.rend(); ++it)
+		{
+			if (view.player->IsArenaStateAcknowledged(*it))
+			{
+				confirmedStateId = *it;
+				view.recordStateIds.erase(view.recordStateIds.begin(), it.base());
+				break;
+			}
+		}
+
+		if (!confirmedStateId)
+			return;
+
+		// State ids wrap around
+		auto IsConfirmed = [&](const std::optional<Nz::UInt16>& firstStateId)
+		{
+			return firstStateId && static_cast<Nz::UInt16>(*confirmedStateId - *firstStateId) < 0x8000;
+		};
+
+		view.pendingCreations.erase(std::remove_if(view.pendingCreations.begin(), view.pendingCreations.end(), [&](const PendingCreation& creation) { return IsConfirmed(creation.firstStateId); }), view.pendingCreations.end());
+		view.pendingDeletions.erase(std::remove_if(view.pendingDeletions.begin(), view.pendingDeletions.end(), [&](const PendingDeletion& deletion) { return IsConfirmed(deletion.firstStateId); }), view.pendingDeletions.end());
 	}
 
-	void BroadcastSystem::OnEntityValidation(Ndk::Entity* entity, bool justAdded)
+	void BroadcastSystem::FillEntityCreation(Ndk::Entity* entity, Packets::ArenaState::CreatedEntity& entityData)
 	{
 		auto& nodeComponent = entity->GetComponent<Ndk::NodeComponent>();
 		auto& syncComponent = entity->GetComponent<SynchronizedComponent>();
 
+		entityData.prefabId = Nz::UInt32(syncComponent.GetPrefabId());
+		entityData.position = nodeComponent.GetPosition();
+		entityData.rotation = nodeComponent.GetRotation();
+		entityData.visualName = syncComponent.GetName();
+
 		if (entity->HasComponent<Ndk::PhysicsComponent3D>())
-			m_movingEntities.Insert(entity);
+		{
+			auto& physComponent = entity->GetComponent<Ndk::PhysicsComponent3D>();
+
+			entityData.angularVelocity = physComponent.GetAngularVelocity();
+			entityData.linearVelocity = physComponent.GetLinearVelocity();
+		}
 		else
-			m_movingEntities.Remove(entity);
+		{
+			entityData.angularVelocity = Nz::Vector3f::Zero();
+			entityData.linearVelocity = Nz::Vector3f::Zero();
+		}
+	}
 
-		if (justAdded)
-			m_createdEntities.UnboundedSet(entity->GetId());
+	void BroadcastSystem::OnEntityRemoved(Ndk::Entity* entity)
+	{
+		m_movingEntities.Remove(entity);
+		m_staticEntities.Remove(entity);
+
+		m_deletedEntities.UnboundedSet(entity->GetId());
 	}
 
-	void BroadcastSystem::OnUpdate(float /*elapsedTime*/)
+	void BroadcastSystem::OnEntityValidation(Ndk::Entity* entity, bool /*justAdded*/)
 	{
-		static constexpr std::size_t HeaderSize = sizeof(Nz::UInt16) + 2 * sizeof(Nz::UInt64) + sizeof(Nz::UInt32);
-		static constexpr std::size_t EntitySize = sizeof(Packets::ArenaState::Entity);
-		static constexpr std::size_t EntityMaxSize = 1300;
-		static constexpr std::size_t MaxEntityPerUpdate = EntityMaxSize / EntitySize;
+		if (entity->HasComponent<Ndk::PhysicsComponent3D>())
+		{
+			m_movingEntities.Insert(entity);
+			m_staticEntities.Remove(entity);
+		}
+		else
+		{
+			m_movingEntities.Remove(entity);
+			m_staticEntities.Insert(entity);
+		}
+	}
 
-		// Handle entities suppression
+	void BroadcastSystem::OnUpdate(float elapsedTime)
+	{
+		// Handle entities suppression for players knowing them (before relevance update, in case an id got reused)
 		if (m_deletedEntities.TestAny())
 		{
-			m_deletedEntitiesPacket.entities.clear();
-			for (std::size_t entityId = m_deletedEntities.FindFirst(); entityId != m_deletedEntities.npos; entityId = m_deletedEntities.FindNext(entityId))
-				m_deletedEntitiesPacket.entities.emplace_back(static_cast<Nz::UInt32>(entityId));
+			for (PlayerView& view : m_playerViews)
+			{
+				for (std::size_t entityId = m_deletedEntities.FindFirst(); entityId != m_deletedEntities.npos; entityId = m_deletedEntities.FindNext(entityId))
+				{
+					if (view.relevantEntities.UnboundedTest(entityId))
+					{
+						view.relevantEntities.Reset(entityId);
+						QueueEntityDeletion(view, entityId);
+					}
+				}
+			}
 
 			m_deletedEntities.Clear();
+		}
 
-			BroadcastEntitiesDestruction(this, m_deletedEntitiesPacket);
+		// Gather moving entities data once, in a contiguous array
+		for (const MovingEntityData& entityData : m_movingEntityData)
+			m_movingEntityIndices[entityData.state.id] = InvalidMovingEntityIndex;
 
+		m_movingEntityData.clear();
+		m_movingEntitiesGrid.Clear();
+		for (const Ndk::EntityHandle& entity : m_movingEntities)
+		{
+			auto& entityPhys = entity->GetComponent<Ndk::PhysicsComponent3D>();
+			auto& entitySync = entity->GetComponent<SynchronizedComponent>();
+
+			// Store values as clients will decode them, so baselines match on both sides and small changes don't count as changes
+			auto& entityData = m_movingEntityData.emplace_back();
+			entityData.priority = entitySync.GetPriority();
+			entityData.state.id = entity->GetId();
+			entityData.state.fields = EntityStateFieldFlags::ValueMask;
+			entityData.state.angularVelocity = Packets::ArenaState::AngularVelocityType(entityPhys.GetAngularVelocity());
+			entityData.state.linearVelocity = Packets::ArenaState::LinearVelocityType(entityPhys.GetLinearVelocity());
+			entityData.state.position = Packets::ArenaState::PositionType(entityPhys.GetPosition());
+			entityData.state.rotation = Packets::ArenaState::RotationType(entityPhys.GetRotation());
+
+			if (m_movingEntityIndices.size() <= entityData.state.id)
+				m_movingEntityIndices.resize(entityData.state.id + 1, InvalidMovingEntityIndex);
+
+			m_movingEntityIndices[entityData.state.id] = m_movingEntityData.size() - 1;
+			m_movingEntitiesGrid.Insert(entityData.state.id, entityData.state.position);
 		}
 
-		// Handle entities creation
-		if (m_createdEntities.TestAny())
+		for (PlayerView& view : m_playerViews)
+		{
+			UpdatePlayerRelevance(view);
+			SendPlayerState(view, elapsedTime);
+		}
+	}
+
+	void BroadcastSystem::QueueEntityCreation(PlayerView& view, std::size_t entityId)
+	{
+		if (view.entityGenerations.size() <= entityId)
+			view.entityGenerations.resize(entityId + 1, 0);
+
+		// Creation data will be filled when first sent
+		auto& creation = view.pendingCreations.emplace_back();
+		creation.data.id = static_cast<Nz::UInt32>(entityId);
+		creation.data.generation = ++view.entityGenerations[entityId];
+
+		view.unannouncedEntities.UnboundedSet(entityId);
+
+		ResetEntityPriority(view, entityId, Nz::Vector3f::Zero(), Nz::Vector3f::Zero());
+	}
+
+	void BroadcastSystem::QueueEntityDeletion(PlayerView& view, std::size_t entityId)
+	{
+		view.unannouncedEntities.UnboundedReset(entityId);
+
+		auto it = std::find_if(view.pendingCreations.begin(), view.pendingCreations.end(), [=](const PendingCreation& creation) { return creation.data.id == entityId; });
+		if (it != view.pendingCreations.end())
 		{
-			m_createdEntitiesPacket.entities.clear();
-			for (std::size_t entityId = m_createdEntities.FindFirst(); entityId != m_createdEntities.npos; entityId = m_createdEntities.FindNext(entityId))
-				AppendEntity(GetWorld().GetEntity(entityId), m_createdEntitiesPacket);
+			bool creationSent = it->firstStateId.has_value();
+			view.pendingCreations.erase(it);
 
-			m_createdEntities.Clear();
+			// Player never heard of this entity
+			if (!creationSent)
+				return;
+		}
 
-			BroadcastEntitiesCreation(this, m_createdEntitiesPacket);
+		auto& deletion = view.pendingDeletions.emplace_back();
+		deletion.data.id = static_cast<Nz::UInt32>(entityId);
+		deletion.data.generation = view.entityGenerations[entityId];
+	}
 
+	void BroadcastSystem::ResetEntityPriority(PlayerView& view, std::size_t entityId, const Nz::Vector3f& angularVelocity, const Nz::Vector3f& linearVelocity)
+	{
+		EntityPriorities& priorities = view.priorities;
+		if (priorities.accumulators.size() <= entityId)
+		{
+			std::size_t entityCount = entityId + 1;
+			priorities.accumulators.resize(entityCount, 0);
+			priorities.sentAngularVelocities.resize(entityCount, Nz::Vector3f::Zero());
+			priorities.sentLinearVelocities.resize(entityCount, Nz::Vector3f::Zero());
 		}
 
-		// Handle entities movement
-		m_priorityQueue.clear();
-		m_priorityQueue.reserve(m_movingEntities.size());
+		priorities.accumulators[entityId] = 0;
+		priorities.sentAngularVelocities[entityId] = angularVelocity;
+		priorities.sentLinearVelocities[entityId] = linearVelocity;
+	}
+
+	void BroadcastSystem::SendPlayerState(PlayerView& view, float elapsedTime)
+	{
+		// Velocity changes (since last sent to this player) at which an entity accumulates priority twice as fast
+		static constexpr float AngularVelocityChangeScale = 1.f;
+		static constexpr float LinearVelocityChangeScale = 50.f;
+
+		// Accumulate priority of relevant moving entities, up to twice as fast for closer ones and again for ones whose velocity changed
+		m_statePacker.Clear();
+
+		EntityPriorities& priorities = view.priorities;
 
-		for (const Ndk::EntityHandle& entities : m_movingEntities)
+		for (std::size_t entityId = view.relevantEntities.FindFirst(); entityId != view.relevantEntities.npos; entityId = view.relevantEntities.FindNext(entityId))
 		{
-			auto& entitySync = entities->GetComponent<SynchronizedComponent>();
-			entitySync.AccumulatePriority();
+			if (entityId >= m_movingEntityIndices.size() || m_movingEntityIndices[entityId] == InvalidMovingEntityIndex)
+				continue;
+
+			// Entities are given a priority slot when becoming relevant, but their state is only useful once the player knows them
+			assert(entityId < priorities.accumulators.size());
+			if (view.unannouncedEntities.UnboundedTest(entityId))
+				continue;
+
+			std::size_t movingEntityIndex = m_movingEntityIndices[entityId];
+			const MovingEntityData& entityData = m_movingEntityData[movingEntityIndex];
+
+			float priorityFactor = 1.f;
+			if (view.hasInterestCenter)
+			{
+				float distance = entityData.state.position.Distance(view.interestCenter);
+				priorityFactor += std::max(1.f - distance / m_interestRadius, 0.f);
+			}
+
+			float velocityChange = entityData.state.angularVelocity.Distance(priorities.sentAngularVelocities[entityId]) / AngularVelocityChangeScale +
+			                       entityData.state.linearVelocity.Distance(priorities.sentLinearVelocities[entityId]) / LinearVelocityChangeScale;
+
+			priorityFactor *= 1.f + std::min(velocityChange, 1.f);
+
+			Nz::UInt16& priorityAccumulator = priorities.accumulators[entityId];
+			priorityAccumulator = ArenaStatePacker::AccumulatePriority(priorityAccumulator, entityData.priority, priorityFactor);
 
-			Nz::UInt16 priorityAccumulator = entitySync.GetPriorityAccumulator();
 			if (priorityAccumulator == 0)
 				continue;
 
-			auto& priorityData = m_priorityQueue.emplace_back();
-			priorityData.entity = entities;
-			priorityData.priority = priorityAccumulator;
+			m_statePacker.QueueEntity(entityData.state, priorityAccumulator);
 		}
 
-		std::sort(m_priorityQueue.begin(), m_priorityQueue.end(), [](const EntityPriority& lhs, const EntityPriority& rhs)
-		{
-			return lhs.priority > rhs.priority;
-		});
+		// Player bandwidth is estimated by its session from the connection quality, allow a small burst of states when we fell behind
+		float maxCredit = float(ArenaStatePacker::MaxStatesPerUpdate * (ArenaStatePacker::StateMaxSize + ArenaStatePacker::StateOverhead));
+		view.bandwidthCredit = std::min(view.bandwidthCredit + view.player->GetStateBandwidth() * elapsedTime, maxCredit);
 
-		// Fill our packet with at most MaxEntityPerUpdate entities, by priority order
-		m_arenaStatePacket.stateId = m_snapshotId++;
+		m_arenaStatePacket.baselineOffset = 0;
 		m_arenaStatePacket.serverTime = m_app->GetAppTime();
+		m_arenaStatePacket.createdEntities.clear();
+		m_arenaStatePacket.deletedEntities.clear();
+		m_arenaStatePacket.entities.clear();
 
-		std::size_t counter = 0;
+		// Entity lifecycle records are part of the first state of every update until acknowledged, new ones are added as long as they leave room for entities
+		ConfirmEntityRecords(view);
 
-		m_arenaStatePacket.entities.clear();
-		for (const EntityPriority& priority : m_priorityQueue)
+		std::size_t recordsSize = 0;
+		for (const PendingDeletion& deletion : view.pendingDeletions)
 		{
-			if (++counter > MaxEntityPerUpdate)
+			if (!deletion.firstStateId && recordsSize + DeletionRecordSize > ArenaStatePacker::RecordsMaxSize)
 				break;
 
-			auto& entityPhys = priority.entity->GetComponent<Ndk::PhysicsComponent3D>();
-			auto& entitySync = priority.entity->GetComponent<SynchronizedComponent>();
-
-			entitySync.ResetPriorityAccumulator();
-
-			Packets::ArenaState::Entity entityData;
-			entityData.id = priority.entity->GetId();
-			entityData.angularVelocity = entityPhys.GetAngularVelocity();
-			entityData.linearVelocity = entityPhys.GetLinearVelocity();
-			entityData.position = entityPhys.GetPosition();
-			entityData.rotation = entityPhys.GetRotation();
+			recordsSize += DeletionRecordSize;
+			m_arenaStatePacket.deletedEntities.push_back(deletion.data);
+		}
 
-			m_arenaStatePacket.entities.emplace_back(std::move(entityData));
+		Ndk::World& world = GetWorld();
+		for (PendingCreation& creation : view.pendingCreations)
+		{
+			// Entities are sent as they are when their creation is first sent
+			if (!creation.firstStateId)
+			{
+				FillEntityCreation(world.GetEntity(creation.data.id), creation.data);
+				if (recordsSize + CreationRecordSize + creation.data.visualName.GetSize() > ArenaStatePacker::RecordsMaxSize)
+					break;
+			}
+
+			recordsSize += CreationRecordSize + creation.data.visualName.GetSize();
+			m_arenaStatePacket.createdEntities.push_back(creation.data);
 		}
 
-		BroadcastStateUpdate(this, m_arenaStatePacket);
+		auto getBaseline = [&]()
+		{
+			return view.player->GetArenaStateBaseline();
+		};
+
+		auto sendState = [&](Packets::ArenaState& statePacket)
+		{
+			BroadcastStateUpdate(this, view.player, statePacket);
+
+			for (const Packets::ArenaState::Entity& entityData : statePacket.entities)
+				ResetEntityPriority(view, entityData.id, entityData.angularVelocity, entityData.linearVelocity);
+
+			// Records included in this state are pending records prefixes
+			for (std::size_t i = 0; i < statePacket.deletedEntities.size(); ++i)
+			{
+				PendingDeletion& deletion = view.pendingDeletions[i];
+				if (!deletion.firstStateId)
+					deletion.firstStateId = statePacket.stateId;
+			}
+
+			for (std::size_t i = 0; i < statePacket.createdEntities.size(); ++i)
+			{
+				PendingCreation& creation = view.pendingCreations[i];
+				if (!creation.firstStateId)
+				{
+					creation.firstStateId = statePacket.stateId;
+
+					// Creation carries velocities, which are the ones known by the client from now on
+					view.unannouncedEntities.Reset(creation.data.id);
+					ResetEntityPriority(view, creation.data.id, creation.data.angularVelocity, creation.data.linearVelocity);
+				}
+			}
+
+			if (!statePacket.createdEntities.empty() || !statePacket.deletedEntities.empty())
+			{
+				view.recordStateIds.push_back(statePacket.stateId);
+				if (view.recordStateIds.size() > MaxRecordStates)
+					view.recordStateIds.erase(view.recordStateIds.begin());
+			}
+		};
+
+		m_statePacker.PackStates(m_arenaStatePacket, recordsSize, view.bandwidthCredit, getBaseline, sendState);
 	}
 
-	void BroadcastSystem::AppendEntity(Ndk::Entity* entity, Packets::CreateEntities& createPacket)
+	void BroadcastSystem::UpdatePlayerRelevance(PlayerView& view)
 	{
-		auto& nodeComponent = entity->GetComponent<Ndk::NodeComponent>();
-		auto& syncComponent = entity->GetComponent<SynchronizedComponent>();
+		// Keep entities a bit further than the interest radius before dropping them, so they don't flicker at its border
+		constexpr float LeaveRadiusFactor = 1.2f;
 
-		auto& entityData = createPacket.entities.emplace_back();
+		Ndk::World& world = GetWorld();
 
-		entityData.prefabId = Nz::UInt32(syncComponent.GetPrefabId());
-		entityData.entityId = entity->GetId();
-		entityData.position = nodeComponent.GetPosition();
-		entityData.rotation = nodeComponent.GetRotation();
-		entityData.visualName = syncComponent.GetName();
+		// Interest is centered on the controlled entity, players without one (spectating) are interested in the whole arena
+		const Ndk::EntityHandle& controlledEntity = view.player->GetControlledEntity();
+		view.hasInterestCenter = (controlledEntity && controlledEntity->GetWorld() == &world);
+		if (view.hasInterestCenter)
+			view.interestCenter = controlledEntity->GetComponent<Ndk::NodeComponent>().GetPosition();
 
-		if (entity->HasComponent<Ndk::PhysicsComponent3D>())
-		{
-			auto& physComponent = entity->GetComponent<Ndk::PhysicsComponent3D>();
+		// Static entities are always relevant
+		m_relevantEntities.Clear();
+		for (const Ndk::EntityHandle& entity : m_staticEntities)
+			m_relevantEntities.UnboundedSet(entity->GetId());
 
-			entityData.angularVelocity = physComponent.GetAngularVelocity();
-			entityData.linearVelocity = physComponent.GetLinearVelocity();
+		if (view.hasInterestCenter)
+		{
+			float squaredRadius = m_interestRadius * m_interestRadius;
+			m_movingEntitiesGrid.ForEachInSphere(view.interestCenter, m_interestRadius * LeaveRadiusFactor, [&](std::size_t entityId, const Nz::Vector3f& position)
+			{
+				if (position.SquaredDistance(view.interestCenter) <= squaredRadius || view.relevantEntities.UnboundedTest(entityId))
+					m_relevantEntities.UnboundedSet(entityId);
+			});
 		}
 		else
 		{
-			entityData.angularVelocity = Nz::Vector3f::Zero();
-			entityData.linearVelocity = Nz::Vector3f::Zero();
+			for (const Ndk::EntityHandle& entity : m_movingEntities)
+				m_relevantEntities.UnboundedSet(entity->GetId());
 		}
-	}
 
-	void BroadcastSystem::CreateAllEntities(Packets::CreateEntities& packetVector)
-	{
-		for (const Ndk::EntityHandle& entity : GetEntities())
-			AppendEntity(entity, packetVector);
+		// Entities leaving relevance
+		for (std::size_t entityId = view.relevantEntities.FindFirst(); entityId != view.relevantEntities.npos; entityId = view.relevantEntities.FindNext(entityId))
+		{
+			if (!m_relevantEntities.UnboundedTest(entityId))
+				QueueEntityDeletion(view, entityId);
+		}
+
+		// Entities entering relevance
+		for (std::size_t entityId = m_relevantEntities.FindFirst(); entityId != m_relevantEntities.npos; entityId = m_relevantEntities.FindNext(entityId))
+		{
+			if (!view.relevantEntities.UnboundedTest(entityId))
+				QueueEntityCreation(view, entityId);
+		}
+
+		std::swap(view.relevantEntities, m_relevantEntities);
 	}
 
 	Ndk::SystemIndex BroadcastSystem::systemIndex;
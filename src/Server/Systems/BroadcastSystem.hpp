@@ -10,10 +10,15 @@
 #include <NDK/EntityList.hpp>
 #include <NDK/System.hpp>
 #include <Shared/Protocol/Packets.hpp>
+#include <Server/ArenaStatePacker.hpp>
+#include <Server/SpatialGrid.hpp>
+#include <limits>
+#include <optional>
 #include <vector>
 
 namespace ewn
 {
+	class Player;
 	class ServerApplication;
 
 	class BroadcastSystem : public Ndk::System<BroadcastSystem>
@@ -22,37 +27,92 @@ namespace ewn
 			BroadcastSystem(ServerApplication* app);
 			~BroadcastSystem() = default;
 
-			void AppendEntity(Ndk::Entity* entity, Packets::CreateEntities& createPacket);
-			void CreateAllEntities(Packets::CreateEntities& packetVector);
+			void AddPlayer(Player* player);
 
-			NazaraSignal(BroadcastEntitiesCreation, const BroadcastSystem*, const Packets::CreateEntities& /*packet*/);
-			NazaraSignal(BroadcastEntitiesDestruction, const BroadcastSystem*, const Packets::DeleteEntities& /*packet*/);
-			NazaraSignal(BroadcastStateUpdate, const BroadcastSystem*, Packets::ArenaState& /*statePacket*/);
+			void RemovePlayer(Player* player);
+
+			NazaraSignal(BroadcastStateUpdate, const BroadcastSystem*, Player* /*player*/, Packets::ArenaState& /*statePacket*/);
 
 			static Ndk::SystemIndex systemIndex;
 
 		private:
+			struct PlayerView;
+
+			void ConfirmEntityRecords(PlayerView& view);
+			void FillEntityCreation(Ndk::Entity* entity, Packets::ArenaState::CreatedEntity& entityData);
+
 			void OnEntityRemoved(Ndk::Entity* entity) override;
 			void OnEntityValidation(Ndk::Entity* entity, bool justAdded) override;
 			void OnUpdate(float elapsedTime) override;
 
-			struct EntityPriority
+			void QueueEntityCreation(PlayerView& view, std::size_t entityId);
+			void QueueEntityDeletion(PlayerView& view, std::size_t entityId);
+
+			void ResetEntityPriority(PlayerView& view, std::size_t entityId, const Nz::Vector3f& angularVelocity, const Nz::Vector3f& linearVelocity);
+			void SendPlayerState(PlayerView& view, float elapsedTime);
+			void UpdatePlayerRelevance(PlayerView& view);
+
+			static constexpr std::size_t CreationRecordSize = 64; //< Estimation without visual name
+			static constexpr std::size_t DeletionRecordSize = 5; //< Estimation
+			static constexpr std::size_t InvalidMovingEntityIndex = std::numeric_limits<std::size_t>::max();
+			static constexpr std::size_t MaxRecordStates = 32; //< Players only remember acknowledgments of their last 32 states
+
+			// Moving entity data gathered once per update and shared by all players
+			struct MovingEntityData
 			{
-				Ndk::Entity* entity;
+				Packets::ArenaState::Entity state;
 				Nz::UInt16 priority;
 			};
 
-			std::vector<EntityPriority> m_priorityQueue;
+			// Per-player priority state of entities, indexed by entity id
+			struct EntityPriorities
+			{
+				std::vector<Nz::UInt16> accumulators;
+				std::vector<Nz::Vector3f> sentAngularVelocities;
+				std::vector<Nz::Vector3f> sentLinearVelocities;
+			};
+
+			// Entity lifecycle records, repeated in the first state of every update from firstStateId until one of them gets acknowledged
+			struct PendingCreation
+			{
+				Packets::ArenaState::CreatedEntity data;
+				std::optional<Nz::UInt16> firstStateId; //< unset until sent
+			};
+
+			struct PendingDeletion
+			{
+				Packets::ArenaState::DeletedEntity data;
+				std::optional<Nz::UInt16> firstStateId; //< unset until sent
+			};
+
+			// What a player knows about the arena
+			struct PlayerView
+			{
+				Player* player;
+				EntityPriorities priorities;
+				Nz::Bitset<> relevantEntities;
+				Nz::Bitset<> unannouncedEntities; //< relevant entities whose creation was not sent yet
+				Nz::Vector3f interestCenter;
+				std::vector<Nz::UInt8> entityGenerations; //< indexed by entity id
+				std::vector<PendingCreation> pendingCreations;
+				std::vector<PendingDeletion> pendingDeletions;
+				std::vector<Nz::UInt16> recordStateIds; //< recent states carrying entity records, oldest first
+				float bandwidthCredit; //< in bytes
+				bool hasInterestCenter;
+			};
+
+			std::vector<MovingEntityData> m_movingEntityData;
+			std::vector<PlayerView> m_playerViews;
+			std::vector<std::size_t> m_movingEntityIndices; //< indexed by entity id
 			Ndk::EntityList m_movingEntities;
-			Nz::Bitset<> m_createdEntities;
+			Ndk::EntityList m_staticEntities;
 			Nz::Bitset<> m_deletedEntities;
-			Nz::UInt16 m_snapshotId;
+			Nz::Bitset<> m_relevantEntities;
 			Packets::ArenaState m_arenaStatePacket;
-			Packets::CreateEntities m_createdEntitiesPacket;
-			Packets::DeleteEntities m_deletedEntitiesPacket;
+			ArenaStatePacker m_statePacker;
 			ServerApplication* m_app;
-			float m_stateUpdateAccumulator;
-			float m_stateUpdateFrequency;
+			SpatialGrid m_movingEntitiesGrid;
+			float m_interestRadius;
 	};
 }
 
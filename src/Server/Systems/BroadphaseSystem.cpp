@@ -0,0 +1,55 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/BroadphaseSystem.hpp>
+#include <NDK/Components/CollisionComponent3D.hpp>
+#include <NDK/Components/NodeComponent.hpp>
+#include <Server/ServerApplication.hpp>
+#include <Server/Components/SignatureComponent.hpp>
+
+namespace ewn
+{
+	BroadphaseSystem::BroadphaseSystem(ServerApplication* app) :
+	m_grid(app->GetConfig().GetFloatOption<float>("Game.BroadphaseCellSize"))
+	{
+		Requires<Ndk::CollisionComponent3D, Ndk::NodeComponent>();
+
+		// Rebuild before physics, so entities killed during last tick are already gone when collision callbacks query us
+		SetUpdateOrder(-1);
+	}
+
+	void BroadphaseSystem::OnUpdate(float /*elapsedTime*/)
+	{
+		m_entityData.clear();
+		m_grid.Clear();
+
+		for (const Ndk::EntityHandle& entity : GetEntities())
+		{
+			auto& entityData = m_entityData.emplace_back();
+			entityData.id = entity->GetId();
+			entityData.position = entity->GetComponent<Ndk::NodeComponent>().GetPosition();
+
+			if (entity->HasComponent<SignatureComponent>())
+			{
+				const SignatureComponent& signature = entity->GetComponent<SignatureComponent>();
+
+				entityData.emSignature = signature.GetEmSignature();
+				entityData.hasSignature = true;
+				entityData.signature = signature.GetSignature();
+				entityData.size = signature.GetSize();
+			}
+			else
+			{
+				entityData.emSignature = 0.0;
+				entityData.hasSignature = false;
+				entityData.signature = entityData.id;
+				entityData.size = -1.0;
+			}
+
+			m_grid.Insert(m_entityData.size() - 1, entityData.position);
+		}
+	}
+
+	Ndk::SystemIndex BroadphaseSystem::systemIndex;
+}
@@ -0,0 +1,51 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_BROADPHASESYSTEM_HPP
+#define EREWHON_SERVER_BROADPHASESYSTEM_HPP
+
+#include <NDK/System.hpp>
+#include <Server/SpatialGrid.hpp>
+#include <vector>
+
+namespace ewn
+{
+	class ServerApplication;
+
+	// Spatial hash of every colliding entity, rebuilt each tick for gameplay proximity queries (radar, communications, explosions)
+	class BroadphaseSystem : public Ndk::System<BroadphaseSystem>
+	{
+		public:
+			struct EntityData
+			{
+				Nz::Int64 signature; //< entity id if it has no signature
+				Nz::Vector3f position;
+				Ndk::EntityId id;
+				bool hasSignature;
+				double emSignature;
+				double size; //< negative if it has no signature
+			};
+
+			BroadphaseSystem(ServerApplication* app);
+			~BroadphaseSystem() = default;
+
+			// Direction must be normalized, half angle is in radians
+			template<typename F> void ForEachInCone(const Nz::Vector3f& origin, const Nz::Vector3f& direction, float length, float halfAngle, F&& callback) const;
+			template<typename F> void ForEachInSphere(const Nz::Vector3f& center, float radius, F&& callback) const;
+
+			static Ndk::SystemIndex systemIndex;
+
+		private:
+			void OnUpdate(float elapsedTime) override;
+
+			std::vector<EntityData> m_entityData;
+			SpatialGrid m_grid;
+	};
+}
+
+#include <Server/Systems/BroadphaseSystem.inl>
+
+#endif // EREWHON_SERVER_BROADPHASESYSTEM_HPP
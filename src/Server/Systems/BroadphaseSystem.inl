@@ -0,0 +1,36 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/BroadphaseSystem.hpp>
+#include <cmath>
+
+namespace ewn
+{
+	template<typename F>
+	void BroadphaseSystem::ForEachInCone(const Nz::Vector3f& origin, const Nz::Vector3f& direction, float length, float halfAngle, F&& callback) const
+	{
+		float cosHalfAngle = std::cos(halfAngle);
+
+		ForEachInSphere(origin, length, [&](const EntityData& entityData)
+		{
+			Nz::Vector3f offset = entityData.position - origin;
+
+			// Compare dot(offset, direction) >= |offset| * cos(halfAngle) without a square root
+			float projection = offset.DotProduct(direction);
+			if (projection < 0.f || projection * projection < offset.GetSquaredLength() * cosHalfAngle * cosHalfAngle)
+				return;
+
+			callback(entityData);
+		});
+	}
+
+	template<typename F>
+	void BroadphaseSystem::ForEachInSphere(const Nz::Vector3f& center, float radius, F&& callback) const
+	{
+		m_grid.ForEachInSphere(center, radius, [&](std::size_t entityIndex, const Nz::Vector3f& /*position*/)
+		{
+			callback(m_entityData[entityIndex]);
+		});
+	}
+}
@@ -3,24 +3,101 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/Systems/LifeTimeSystem.hpp>
+#include <NDK/World.hpp>
 #include <Server/Components/LifeTimeComponent.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 
 namespace ewn
 {
-	LifeTimeSystem::LifeTimeSystem()
+	LifeTimeSystem::LifeTimeSystem() :
+	m_currentTick(0),
+	m_tickAccumulator(0.f)
 	{
 		Requires<LifeTimeComponent>();
 	}
 
-	void LifeTimeSystem::OnUpdate(float elapsedTime)
+	void LifeTimeSystem::AdvanceTick()
 	{
-		for (const Ndk::EntityHandle& entity : GetEntities())
+		m_currentTick++;
+
+		if ((m_currentTick & (InnerWheelSize - 1)) == 0)
+		{
+			std::size_t outerSlot = (m_currentTick >> InnerWheelBits) & (OuterWheelSize - 1);
+
+			// A new outer wheel turn begins, timers which were too far away may fit in the wheels now
+			if (outerSlot == 0)
+			{
+				m_cascadingTimers.swap(m_overflowTimers);
+				for (const Timer& timer : m_cascadingTimers)
+					ScheduleTimer(timer);
+
+				m_cascadingTimers.clear();
+			}
+
+			// Timers of the block beginning now all expire in the next InnerWheelSize ticks
+			m_cascadingTimers.swap(m_outerWheel[outerSlot]);
+			for (const Timer& timer : m_cascadingTimers)
+				ScheduleTimer(timer);
+
+			m_cascadingTimers.clear();
+		}
+
+		auto& expiredTimers = m_innerWheel[m_currentTick & (InnerWheelSize - 1)];
+		for (const Timer& timer : expiredTimers)
 		{
-			LifeTimeComponent& lifeTime = entity->GetComponent<LifeTimeComponent>();
+			// Entities may have been killed (or their id reused) since their timer was scheduled
+			if (!GetEntities().Has(timer.entityId))
+				continue;
 
-			if (lifeTime.DecreaseDuration(elapsedTime))
+			const Ndk::EntityHandle& entity = GetWorld().GetEntity(timer.entityId);
+			if (entity->GetComponent<LifeTimeComponent>().GetExpirationTick() == timer.expirationTick)
 				entity->Kill();
 		}
+
+		expiredTimers.clear();
+	}
+
+	void LifeTimeSystem::OnEntityValidation(Ndk::Entity* entity, bool justAdded)
+	{
+		if (!justAdded)
+			return;
+
+		LifeTimeComponent& lifeTime = entity->GetComponent<LifeTimeComponent>();
+
+		Nz::UInt64 durationTicks = static_cast<Nz::UInt64>(std::ceil(lifeTime.GetDuration() / TickDuration));
+
+		Timer timer;
+		timer.entityId = entity->GetId();
+		timer.expirationTick = m_currentTick + std::max<Nz::UInt64>(durationTicks, 1);
+
+		lifeTime.SetExpirationTick(timer.expirationTick);
+
+		ScheduleTimer(timer);
+	}
+
+	void LifeTimeSystem::OnUpdate(float elapsedTime)
+	{
+		m_tickAccumulator += elapsedTime;
+		while (m_tickAccumulator >= TickDuration)
+		{
+			m_tickAccumulator -= TickDuration;
+			AdvanceTick();
+		}
+	}
+
+	void LifeTimeSystem::ScheduleTimer(const Timer& timer)
+	{
+		assert(timer.expirationTick >= m_currentTick);
+
+		Nz::UInt64 remainingTicks = timer.expirationTick - m_currentTick;
+		if (remainingTicks < InnerWheelSize)
+			m_innerWheel[timer.expirationTick & (InnerWheelSize - 1)].push_back(timer);
+		else if (remainingTicks < InnerWheelSize * OuterWheelSize)
+			m_outerWheel[(timer.expirationTick >> InnerWheelBits) & (OuterWheelSize - 1)].push_back(timer);
+		else
+			m_overflowTimers.push_back(timer);
 	}
 
 	Ndk::SystemIndex LifeTimeSystem::systemIndex;
@@ -8,6 +8,8 @@
 #define EREWHON_SERVER_LIFETIMESYSTEM_HPP
 
 #include <NDK/System.hpp>
+#include <array>
+#include <vector>
 
 namespace ewn
 {
@@ -20,7 +22,33 @@ namespace ewn
 			static Ndk::SystemIndex systemIndex;
 
 		private:
+			struct Timer;
+
+			void AdvanceTick();
+			void OnEntityValidation(Ndk::Entity* entity, bool justAdded) override;
 			void OnUpdate(float elapsedTime) override;
+			void ScheduleTimer(const Timer& timer);
+
+			static constexpr float TickDuration = 0.05f;
+			static constexpr std::size_t InnerWheelBits = 8;
+			static constexpr std::size_t InnerWheelSize = 1 << InnerWheelBits;
+			static constexpr std::size_t OuterWheelBits = 6;
+			static constexpr std::size_t OuterWheelSize = 1 << OuterWheelBits;
+
+			struct Timer
+			{
+				Ndk::EntityId entityId;
+				Nz::UInt64 expirationTick;
+			};
+
+			// Hierarchical timing wheel: the inner wheel holds timers expiring in the next InnerWheelSize ticks,
+			// the outer one holds later timers by block of InnerWheelSize ticks, which are cascaded into the inner wheel when their block begins
+			std::array<std::vector<Timer>, InnerWheelSize> m_innerWheel;
+			std::array<std::vector<Timer>, OuterWheelSize> m_outerWheel;
+			std::vector<Timer> m_cascadingTimers;
+			std::vector<Timer> m_overflowTimers;
+			Nz::UInt64 m_currentTick;
+			float m_tickAccumulator;
 	};
 }
 
@@ -0,0 +1,109 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/RadarSystem.hpp>
+#include <NDK/World.hpp>
+#include <NDK/Components/NodeComponent.hpp>
+#include <Server/ServerApplication.hpp>
+#include <algorithm>
+
+namespace ewn
+{
+	RadarSystem::RadarSystem(ServerApplication* app) :
+	m_app(app)
+	{
+		Requires<Ndk::NodeComponent, RadarComponent>();
+	}
+
+	void RadarSystem::OnUpdate(float /*elapsedTime*/)
+	{
+		Nz::UInt64 now = m_app->GetAppTime();
+
+		Ndk::World& world = GetWorld();
+		const BroadphaseSystem& broadphase = world.GetSystem<BroadphaseSystem>();
+
+		// All scans due this tick are answered from the same broadphase, rebuilt earlier this tick
+		for (const Ndk::EntityHandle& entity : GetEntities())
+		{
+			RadarComponent& radar = entity->GetComponent<RadarComponent>();
+			if (now - radar.GetLastScanTime() <= ScanInterval)
+				continue;
+
+			radar.SetLastScanTime(now);
+
+			Ndk::EntityId radarEntityId = entity->GetId();
+			Nz::Vector3f radarPosition = entity->GetComponent<Ndk::NodeComponent>().GetPosition();
+
+			m_entitiesInRange.clear();
+			broadphase.ForEachInSphere(radarPosition, radar.GetDetectionRadius(), [&](const BroadphaseSystem::EntityData& entityData)
+			{
+				if (entityData.id != radarEntityId)
+					m_entitiesInRange.push_back(&entityData);
+			});
+
+			std::sort(m_entitiesInRange.begin(), m_entitiesInRange.end(), [](const BroadphaseSystem::EntityData* first, const BroadphaseSystem::EntityData* second)
+			{
+				return first->id < second->id;
+			});
+
+			m_newContacts.clear();
+			m_lostContacts.clear();
+			m_updatedContacts.clear();
+
+			bool acceptNewContacts = radar.IsPassiveScanEnabled();
+			auto AddContact = [&](const BroadphaseSystem::EntityData* entityData)
+			{
+				if (!acceptNewContacts)
+					return;
+
+				m_newContacts.push_back(entityData);
+
+				auto& contact = m_updatedContacts.emplace_back();
+				contact.entity = world.GetEntity(entityData->id);
+				contact.entityId = entityData->id;
+				contact.hasSignature = entityData->hasSignature;
+				contact.signature = entityData->signature;
+			};
+
+			// Both lists are sorted by entity id, walk them together to find new and lost contacts
+			// (contacts whose entity has been destroyed are dropped, their id may have been reused by a new contact)
+			const std::vector<RadarComponent::Contact>& contacts = radar.GetContacts();
+
+			auto contactIt = contacts.begin();
+			auto inRangeIt = m_entitiesInRange.begin();
+			while (contactIt != contacts.end() || inRangeIt != m_entitiesInRange.end())
+			{
+				if (inRangeIt == m_entitiesInRange.end() || (contactIt != contacts.end() && contactIt->entityId < (*inRangeIt)->id))
+				{
+					if (contactIt->entity)
+						m_lostContacts.push_back(*contactIt);
+
+					++contactIt;
+				}
+				else if (contactIt == contacts.end() || (*inRangeIt)->id < contactIt->entityId)
+				{
+					AddContact(*inRangeIt);
+					++inRangeIt;
+				}
+				else
+				{
+					if (contactIt->entity)
+						m_updatedContacts.push_back(*contactIt);
+					else
+						AddContact(*inRangeIt);
+
+					++contactIt;
+					++inRangeIt;
+				}
+			}
+
+			radar.GetContacts().swap(m_updatedContacts);
+
+			if (!m_newContacts.empty() || !m_lostContacts.empty())
+				radar.OnContactsUpdate(&radar, radarPosition, m_newContacts, m_lostContacts);
+		}
+	}
+
+	Ndk::SystemIndex RadarSystem::systemIndex;
+}
@@ -0,0 +1,42 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_RADARSYSTEM_HPP
+#define EREWHON_SERVER_RADARSYSTEM_HPP
+
+#include <NDK/System.hpp>
+#include <Server/Components/RadarComponent.hpp>
+#include <Server/Systems/BroadphaseSystem.hpp>
+#include <vector>
+
+namespace ewn
+{
+	class ServerApplication;
+
+	class RadarSystem : public Ndk::System<RadarSystem>
+	{
+		public:
+			RadarSystem(ServerApplication* app);
+			~RadarSystem() = default;
+
+			static Ndk::SystemIndex systemIndex;
+
+		private:
+			void OnUpdate(float elapsedTime) override;
+
+			static constexpr Nz::UInt64 ScanInterval = 500;
+
+			std::vector<const BroadphaseSystem::EntityData*> m_entitiesInRange;
+			std::vector<const BroadphaseSystem::EntityData*> m_newContacts;
+			std::vector<RadarComponent::Contact> m_lostContacts;
+			std::vector<RadarComponent::Contact> m_updatedContacts;
+			ServerApplication* m_app;
+	};
+}
+
+#include <Server/Systems/RadarSystem.inl>
+
+#endif // EREWHON_SERVER_RADARSYSTEM_HPP
@@ -0,0 +1,9 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/RadarSystem.hpp>
+
+namespace ewn
+{
+}
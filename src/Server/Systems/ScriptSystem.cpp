@@ -4,30 +4,219 @@
 
 #include <Server/Systems/ScriptSystem.hpp>
 #include <Server/Arena.hpp>
+#include <Server/ServerApplication.hpp>
 #include <Server/Components/OwnerComponent.hpp>
 #include <Server/Components/ScriptComponent.hpp>
 #include <Server/Components/SynchronizedComponent.hpp>
+#include <algorithm>
+#include <iostream>
 
 namespace ewn
 {
 	ScriptSystem::ScriptSystem(ServerApplication* app, Arena* arena) :
+	m_running(true),
+	m_nextJob(0),
+	m_activeWorkers(0),
 	m_arena(arena),
-	m_app(app)
+	m_app(app),
+	m_jobGeneration(0),
+	m_elapsedTime(0.f)
 	{
 		Requires<ScriptComponent>();
 
 		SetMaximumUpdateRate(100.f);
+
+		m_statsReportInterval = app->GetConfig().GetIntegerOption<Nz::UInt64>("Game.ScriptStatsInterval") * 1'000;
+		m_nextStatsReport = app->GetAppTime() + m_statsReportInterval;
+
+		std::size_t workerCount = app->GetConfig().GetIntegerOption<std::size_t>("Game.ScriptWorkerCount");
+
+		m_workers.reserve(workerCount);
+		for (std::size_t i = 0; i < workerCount; ++i)
+		{
+			Nz::Thread& worker = m_workers.emplace_back(&ScriptSystem::WorkerThread, this);
+			worker.SetName("ScriptWorker");
+		}
+	}
+
+	ScriptSystem::ScriptSystem(const ScriptSystem& system) :
+	ScriptSystem(system.m_app, system.m_arena)
+	{
+	}
+
+	ScriptSystem::~ScriptSystem()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_jobMutex);
+			m_running.store(false, std::memory_order_release);
+		}
+		m_jobCondition.notify_all();
+
+		for (Nz::Thread& worker : m_workers)
+			worker.Join();
+	}
+
+	std::vector<std::string> ScriptSystem::BuildStatsReport(std::size_t maxOwnerCount)
+	{
+		struct OwnerStats
+		{
+			Player* owner;
+			std::size_t scriptCount;
+			ScriptComponent::Stats stats;
+		};
+
+		auto AccumulateStats = [](ScriptComponent::Stats& total, const ScriptComponent::Stats& stats)
+		{
+			total.callbackCount += stats.callbackCount;
+			total.callbackTime += stats.callbackTime;
+			total.maxCallbackTime = std::max(total.maxCallbackTime, stats.maxCallbackTime);
+			total.memoryUsage += stats.memoryUsage;
+			total.peakMemoryUsage = std::max(total.peakMemoryUsage, stats.peakMemoryUsage); //< Largest script peak, to compare with the per-script limit
+		};
+
+		ScriptComponent::Stats arenaStats = {};
+		std::vector<OwnerStats> ownerStats;
+
+		for (const Ndk::EntityHandle& entity : GetEntities())
+		{
+			ScriptComponent& script = entity->GetComponent<ScriptComponent>();
+
+			Player* owner = nullptr;
+			if (entity->HasComponent<OwnerComponent>())
+				owner = entity->GetComponent<OwnerComponent>().GetOwner();
+
+			auto it = std::find_if(ownerStats.begin(), ownerStats.end(), [&](const OwnerStats& entry) { return entry.owner == owner; });
+			if (it == ownerStats.end())
+			{
+				it = ownerStats.emplace(ownerStats.end());
+				it->owner = owner;
+				it->scriptCount = 0;
+				it->stats = {};
+			}
+
+			it->scriptCount++;
+			AccumulateStats(it->stats, script.GetStats());
+			AccumulateStats(arenaStats, script.GetStats());
+
+			// Each report covers what happened since the previous one
+			script.ResetStats();
+		}
+
+		std::sort(ownerStats.begin(), ownerStats.end(), [](const OwnerStats& lhs, const OwnerStats& rhs)
+		{
+			return lhs.stats.callbackTime > rhs.stats.callbackTime;
+		});
+
+		auto FormatStats = [](std::size_t scriptCount, const ScriptComponent::Stats& stats)
+		{
+			return std::to_string(scriptCount) + " script(s), " + std::to_string(stats.callbackCount) + " callback(s), "
+			       "CPU " + std::to_string(stats.callbackTime / 1'000) + "ms (max " + std::to_string(stats.maxCallbackTime) + "us per callback), "
+			       "memory " + std::to_string(stats.memoryUsage / 1'024) + "KiB (max peak " + std::to_string(stats.peakMemoryUsage / 1'024) + "KiB per script)";
+		};
+
+		std::vector<std::string> report;
+		report.push_back("Scripts: " + FormatStats(GetEntities().size(), arenaStats));
+
+		std::size_t ownerCount = std::min(ownerStats.size(), maxOwnerCount);
+		for (std::size_t i = 0; i < ownerCount; ++i)
+		{
+			const OwnerStats& entry = ownerStats[i];
+			report.push_back("- " + ((entry.owner) ? entry.owner->GetName() : std::string("<no owner>")) + ": " + FormatStats(entry.scriptCount, entry.stats));
+		}
+
+		return report;
 	}
 
 	void ScriptSystem::OnUpdate(float elapsedTime)
 	{
+		m_jobs.clear();
 		for (const Ndk::EntityHandle& entity : GetEntities())
 		{
 			ScriptComponent& script = entity->GetComponent<ScriptComponent>();
+			if (!script.HasValidScript())
+				continue;
+
+			ScriptJob& job = m_jobs.emplace_back();
+			job.script = &script;
+			job.succeeded = true;
+		}
+
+		m_elapsedTime = elapsedTime;
+		m_nextJob.store(0, std::memory_order_relaxed);
+
+		// Phase one: every bot runs its own Lua state, world is only read and changes are queued as commands
+		if (!m_workers.empty() && m_jobs.size() > 1)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_jobMutex);
+				m_activeWorkers = m_workers.size();
+				m_jobGeneration++;
+			}
+			m_jobCondition.notify_all();
+
+			// Help the workers instead of just waiting for them
+			RunJobs();
+
+			std::unique_lock<std::mutex> lock(m_jobMutex);
+			m_idleCondition.wait(lock, [&]() { return m_activeWorkers == 0; });
+		}
+		else
+			RunJobs();
+
+		// Phase two: apply queued commands in entity order, so the outcome doesn't depend on thread scheduling
+		for (ScriptJob& job : m_jobs)
+		{
+			if (!job.succeeded)
+				job.script->SendMessage(BotMessageType::Error, job.lastError);
+
+			job.script->ProcessCommands();
+		}
+
+		if (m_statsReportInterval > 0)
+		{
+			Nz::UInt64 now = m_app->GetAppTime();
+			if (now >= m_nextStatsReport)
+			{
+				constexpr std::size_t MaxReportedOwners = 5;
+
+				for (const std::string& line : BuildStatsReport(MaxReportedOwners))
+					std::cout << "(" << m_arena->GetName() << ") " << line << std::endl;
+
+				m_nextStatsReport = now + m_statsReportInterval;
+			}
+		}
+	}
+
+	void ScriptSystem::RunJobs()
+	{
+		std::size_t jobIndex;
+		while ((jobIndex = m_nextJob.fetch_add(1, std::memory_order_relaxed)) < m_jobs.size())
+		{
+			ScriptJob& job = m_jobs[jobIndex];
+			job.succeeded = job.script->Run(m_app, m_elapsedTime, &job.lastError);
+		}
+	}
+
+	void ScriptSystem::WorkerThread()
+	{
+		Nz::UInt64 lastGeneration = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_jobMutex);
+				m_jobCondition.wait(lock, [&]() { return !m_running.load(std::memory_order_acquire) || m_jobGeneration != lastGeneration; });
+
+				if (!m_running.load(std::memory_order_acquire))
+					break;
+
+				lastGeneration = m_jobGeneration;
+			}
+
+			RunJobs();
 
-			Nz::String lastError;
-			if (!script.Run(m_app, elapsedTime, &lastError))
-				script.SendMessage(BotMessageType::Error, lastError);
+			std::unique_lock<std::mutex> lock(m_jobMutex);
+			if (--m_activeWorkers == 0)
+				m_idleCondition.notify_all();
 		}
 	}
 
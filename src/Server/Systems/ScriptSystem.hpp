@@ -7,26 +7,59 @@
 #ifndef EREWHON_SERVER_SCRIPTSYSTEM_HPP
 #define EREWHON_SERVER_SCRIPTSYSTEM_HPP
 
+#include <Nazara/Core/String.hpp>
+#include <Nazara/Core/Thread.hpp>
 #include <NDK/System.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace ewn
 {
 	class Arena;
+	class ScriptComponent;
 	class ServerApplication;
 
 	class ScriptSystem : public Ndk::System<ScriptSystem>
 	{
 		public:
 			ScriptSystem(ServerApplication* app, Arena* arena);
-			~ScriptSystem() = default;
+			ScriptSystem(const ScriptSystem& system);
+			~ScriptSystem();
+
+			std::vector<std::string> BuildStatsReport(std::size_t maxOwnerCount);
 
 			static Ndk::SystemIndex systemIndex;
 
 		private:
+			struct ScriptJob
+			{
+				ScriptComponent* script;
+				Nz::String lastError;
+				bool succeeded;
+			};
+
 			void OnUpdate(float elapsedTime) override;
 
+			void RunJobs();
+			void WorkerThread();
+
+			std::atomic_bool m_running;
+			std::atomic_size_t m_nextJob;
+			std::condition_variable m_idleCondition;
+			std::condition_variable m_jobCondition;
+			std::mutex m_jobMutex;
+			std::size_t m_activeWorkers; //< Protected by m_jobMutex
+			std::vector<Nz::Thread> m_workers;
+			std::vector<ScriptJob> m_jobs;
 			Arena* m_arena;
 			ServerApplication* m_app;
+			Nz::UInt64 m_jobGeneration; //< Protected by m_jobMutex
+			Nz::UInt64 m_nextStatsReport;
+			Nz::UInt64 m_statsReportInterval;
+			float m_elapsedTime;
 	};
 }
 
@@ -0,0 +1,51 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/TickScheduler.hpp>
+#include <Nazara/Core/Thread.hpp>
+#include <cassert>
+#include <thread>
+
+namespace ewn
+{
+	TickScheduler::TickScheduler(unsigned int tickRate, unsigned int maxCatchUpTicks) :
+	m_maxCatchUpTicks(maxCatchUpTicks)
+	{
+		assert(tickRate > 0);
+		assert(maxCatchUpTicks > 0);
+
+		m_tickDuration = 1'000'000 / tickRate;
+		m_nextTick = m_clock.GetMicroseconds();
+	}
+
+	unsigned int TickScheduler::WaitNextTick()
+	{
+		// OS sleep granularity is around a millisecond, spin for the last part
+		constexpr Nz::UInt64 SpinThreshold = 2'000;
+
+		Nz::UInt64 now = m_clock.GetMicroseconds();
+		while (now < m_nextTick)
+		{
+			Nz::UInt64 remainingTime = m_nextTick - now;
+			if (remainingTime > SpinThreshold)
+				Nz::Thread::Sleep(static_cast<Nz::UInt32>((remainingTime - SpinThreshold) / 1'000 + 1));
+			else
+				std::this_thread::yield();
+
+			now = m_clock.GetMicroseconds();
+		}
+
+		// Run more than one tick if we're late
+		Nz::UInt64 tickCount = 1 + (now - m_nextTick) / m_tickDuration;
+		if (tickCount > m_maxCatchUpTicks)
+		{
+			// We're too late, drop the ticks we can't catch up with
+			m_nextTick = now + m_tickDuration;
+			return m_maxCatchUpTicks;
+		}
+
+		m_nextTick += tickCount * m_tickDuration;
+		return static_cast<unsigned int>(tickCount);
+	}
+}
@@ -0,0 +1,41 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_TICKSCHEDULER_HPP
+#define EREWHON_SERVER_TICKSCHEDULER_HPP
+
+#include <Nazara/Prerequisites.hpp>
+#include <Nazara/Core/Clock.hpp>
+
+namespace ewn
+{
+	class TickScheduler
+	{
+		public:
+			TickScheduler(unsigned int tickRate, unsigned int maxCatchUpTicks);
+			TickScheduler(const TickScheduler&) = delete;
+			TickScheduler(TickScheduler&&) = delete;
+			~TickScheduler() = default;
+
+			inline float GetTickDuration() const;
+			inline Nz::UInt64 GetTickDurationMicroseconds() const;
+
+			unsigned int WaitNextTick();
+
+			TickScheduler& operator=(const TickScheduler&) = delete;
+			TickScheduler& operator=(TickScheduler&&) = delete;
+
+		private:
+			Nz::Clock m_clock;
+			Nz::UInt64 m_nextTick;
+			Nz::UInt64 m_tickDuration; //< in microseconds
+			unsigned int m_maxCatchUpTicks;
+	};
+}
+
+#include <Server/TickScheduler.inl>
+
+#endif // EREWHON_SERVER_TICKSCHEDULER_HPP
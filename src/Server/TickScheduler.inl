@@ -0,0 +1,18 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/TickScheduler.hpp>
+
+namespace ewn
+{
+	inline float TickScheduler::GetTickDuration() const
+	{
+		return m_tickDuration / 1'000'000.f;
+	}
+
+	inline Nz::UInt64 TickScheduler::GetTickDurationMicroseconds() const
+	{
+		return m_tickDuration;
+	}
+}
@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/ServerApplication.hpp>
+#include <Server/SpaceshipCore.hpp>
 #include <Server/Components/ArenaComponent.hpp>
 #include <Server/Components/CommunicationComponent.hpp>
 #include <Server/Components/HealthComponent.hpp>
@@ -12,17 +13,19 @@
 #include <Server/Components/OwnerComponent.hpp>
 #include <Server/Components/PlayerControlledComponent.hpp>
 #include <Server/Components/ProjectileComponent.hpp>
+#include <Server/Components/RadarComponent.hpp>
 #include <Server/Components/ScriptComponent.hpp>
 #include <Server/Components/SignatureComponent.hpp>
 #include <Server/Components/SynchronizedComponent.hpp>
 #include <Server/Scripting/ArenaInterface.hpp>
 #include <Server/Systems/BroadcastSystem.hpp>
+#include <Server/Systems/BroadphaseSystem.hpp>
 #include <Server/Systems/LifeTimeSystem.hpp>
 #include <Server/Systems/NavigationSystem.hpp>
+#include <Server/Systems/RadarSystem.hpp>
 #include <Server/Systems/ScriptSystem.hpp>
 #include <Server/Systems/InputSystem.hpp>
 #include <Nazara/Core/Initializer.hpp>
-#include <Nazara/Core/Thread.hpp>
 #include <Nazara/Network/Network.hpp>
 #include <NDK/Sdk.hpp>
 
@@ -30,7 +33,7 @@ int main()
 {
 	Nz::Initializer<Nz::Network, Ndk::Sdk> nazara; //< Init SDK before application because of custom components/systems
 
-	Nz::Initializer<ewn::ArenaInterface> binding;
+	Nz::Initializer<ewn::ArenaInterface, ewn::SpaceshipCore> binding;
 
 	// Initialize custom components
 	Ndk::InitializeComponent<ewn::ArenaComponent>("Arena");
@@ -42,15 +45,24 @@ int main()
 	Ndk::InitializeComponent<ewn::OwnerComponent>("OwnrComp");
 	Ndk::InitializeComponent<ewn::PlayerControlledComponent>("PlyCtrl");
 	Ndk::InitializeComponent<ewn::ProjectileComponent>("Prjctile");
+	Ndk::InitializeComponent<ewn::RadarComponent>("RadarCmp");
 	Ndk::InitializeComponent<ewn::ScriptComponent>("ScrptCmp");
 	Ndk::InitializeComponent<ewn::SignatureComponent>("SignCmp");
 	Ndk::InitializeComponent<ewn::SynchronizedComponent>("SyncComp");
 	Ndk::InitializeSystem<ewn::BroadcastSystem>();
+	Ndk::InitializeSystem<ewn::BroadphaseSystem>();
 	Ndk::InitializeSystem<ewn::LifeTimeSystem>();
 	Ndk::InitializeSystem<ewn::NavigationSystem>();
+	Ndk::InitializeSystem<ewn::RadarSystem>();
 	Ndk::InitializeSystem<ewn::ScriptSystem>();
 	Ndk::InitializeSystem<ewn::InputSystem>();
 
+	if (!ewn::ScriptComponent::PrecompileLibrary("spacelib.lua"))
+	{
+		std::cerr << "Failed to precompile spacelib.lua" << std::endl;
+		return EXIT_FAILURE;
+	}
+
 	ewn::ServerApplication app;
 	if (!app.LoadConfig("sconfig.lua"))
 	{
@@ -69,7 +81,7 @@ int main()
 	app.CreateArena("Le bac à sable", "sandbox.lua");
 
 	const ewn::ConfigFile& config = app.GetConfig();
-	if (!app.SetupNetwork(config.GetIntegerOption<std::size_t>("Game.MaxClients"), 1, Nz::NetProtocol_Any, config.GetIntegerOption<Nz::UInt16>("Game.Port")))
+	if (!app.SetupNetwork(config.GetIntegerOption<std::size_t>("Game.MaxClients"), config.GetIntegerOption<std::size_t>("Game.ReactorCount"), Nz::NetProtocol_Any, config.GetIntegerOption<Nz::UInt16>("Game.Port")))
 	{
 		std::cerr << "Failed to setup network" << std::endl;
 		return EXIT_FAILURE;
@@ -77,20 +89,8 @@ int main()
 
 	std::cout << "Server ready." << std::endl;
 
-	//Nz::UInt64 lastUpdate = Nz::GetElapsedMilliseconds();
-	//unsigned int updateCount = 0;
-	while (app.Run())
-	{
-		/*Nz::UInt64 now = Nz::GetElapsedMilliseconds();
-		if (now - lastUpdate >= 1000)
-		{
-			std::cout << "Update per seconds: " << updateCount << std::endl;
-			updateCount = 0;
-			lastUpdate = now;
-		}
-		updateCount++;*/
-		Nz::Thread::Sleep(1);
-	}
+	// Ticks are scheduled by the application itself (see Game.TickRate)
+	while (app.Run());
 
 	std::cout << "Goodbye" << std::endl;
 }
@@ -28,7 +28,8 @@ namespace ewn
 	{
 	}
 
-	void BaseApplication::OnConfigLoaded(const ConfigFile& /*config*/)
+	bool BaseApplication::OnConfigLoaded(const ConfigFile& /*config*/)
 	{
+		return true;
 	}
 }
@@ -5,14 +5,44 @@
 #include <Shared/NetworkReactor.hpp>
 #include <Shared/Config.hpp>
 #include <Shared/Utils.hpp>
+#include <Nazara/Core/Clock.hpp>
 #include <cassert>
 #include <condition_variable>
+#include <iostream>
 #include <mutex>
 #include <stdexcept>
 
+#ifdef NAZARA_PLATFORM_WINDOWS
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(NAZARA_PLATFORM_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace ewn
 {
-	NetworkReactor::NetworkReactor(std::size_t firstId, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient) :
+	namespace
+	{
+		bool PinCurrentThread(std::size_t coreIndex)
+		{
+#ifdef NAZARA_PLATFORM_WINDOWS
+			return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << coreIndex) != 0;
+#elif defined(NAZARA_PLATFORM_LINUX)
+			cpu_set_t cpuSet;
+			CPU_ZERO(&cpuSet);
+			CPU_SET(coreIndex, &cpuSet);
+
+			return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+			return false;
+#endif
+		}
+	}
+
+	NetworkReactor::NetworkReactor(std::size_t firstId, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient, std::size_t coreAffinity) :
+	m_coreAffinity(coreAffinity),
 	m_firstId(firstId),
 	m_protocol(protocol)
 	{
@@ -25,6 +55,8 @@ namespace ewn
 			throw std::runtime_error("Failed to start reactor");
 
 		m_clients.resize(maxClient, nullptr);
+		m_outgoingEvents.resize(OutgoingBulkSize);
+		m_pendingBatches.resize(maxClient);
 
 		m_running.store(true, std::memory_order_release);
 		m_thread = Nz::Thread(&NetworkReactor::WorkerThread, this);
@@ -73,13 +105,12 @@ namespace ewn
 	{
 		assert(peerId >= m_firstId);
 
-		OutgoingEvent::DisconnectEvent disconnectEvent;
-		disconnectEvent.data = data;
-		disconnectEvent.type = type;
-
 		OutgoingEvent outgoingData;
 		outgoingData.peerId = peerId - m_firstId;
-		outgoingData.data = std::move(disconnectEvent);
+
+		auto& disconnectEvent = outgoingData.data.emplace<OutgoingEvent::DisconnectEvent>();
+		disconnectEvent.data = data;
+		disconnectEvent.type = type;
 
 		m_outgoingQueue.enqueue(std::move(outgoingData));
 	}
@@ -99,14 +130,30 @@ namespace ewn
 	{
 		assert(peerId >= m_firstId);
 
-		OutgoingEvent::PacketEvent packetEvent;
+		// Build the event in place, the packet will only be moved again when enqueued
+		OutgoingEvent outgoingData;
+		outgoingData.peerId = peerId - m_firstId;
+
+		auto& packetEvent = outgoingData.data.emplace<OutgoingEvent::PacketEvent>();
 		packetEvent.channelId = channelId;
 		packetEvent.packet = std::move(packet);
 		packetEvent.flags = flags;
+		packetEvent.enqueueTime = Nz::GetElapsedMicroseconds();
+
+		m_outgoingQueue.enqueue(std::move(outgoingData));
+	}
+
+	void NetworkReactor::SendData(std::size_t peerId, SharedPacket packet)
+	{
+		assert(peerId >= m_firstId);
+		assert(packet.IsValid());
 
 		OutgoingEvent outgoingData;
 		outgoingData.peerId = peerId - m_firstId;
-		outgoingData.data = std::move(packetEvent);
+
+		auto& packetEvent = outgoingData.data.emplace<OutgoingEvent::SharedPacketEvent>();
+		packetEvent.packet = std::move(packet);
+		packetEvent.enqueueTime = Nz::GetElapsedMicroseconds();
 
 		m_outgoingQueue.enqueue(std::move(outgoingData));
 	}
@@ -117,6 +164,9 @@ namespace ewn
 		moodycamel::ConsumerToken outgoingToken(m_outgoingQueue);
 		moodycamel::ProducerToken incomingToken(m_incomingQueue);
 
+		if (m_coreAffinity != NoCoreAffinity && !PinCurrentThread(m_coreAffinity))
+			std::cerr << "Failed to pin network reactor to core #" << m_coreAffinity << std::endl;
+
 		while (m_running.load(std::memory_order_acquire))
 		{
 			ReceivePackets(incomingToken);
@@ -127,10 +177,10 @@ namespace ewn
 		}
 	}
 
-	void NetworkReactor::HandleConnectionRequests(const moodycamel::ConsumerToken& token)
+	void NetworkReactor::HandleConnectionRequests(moodycamel::ConsumerToken& token)
 {
 		ConnectionRequest request;
-		while (m_connectionRequests.try_dequeue(request))
+		while (m_connectionRequests.try_dequeue(token, request))
 		{
 			if (Nz::ENetPeer* peer = m_host.Connect(request.remoteAddress, NetworkChannelCount, request.data))
 			{
@@ -191,14 +241,7 @@ namespace ewn
 					{
 						Nz::UInt16 peerId = event.peer->GetPeerId();
 
-						IncomingEvent::PacketEvent packetEvent;
-						packetEvent.packet = std::move(event.packet->data);
-
-						IncomingEvent newEvent;
-						newEvent.peerId = m_firstId + peerId;
-						newEvent.data.emplace<IncomingEvent::PacketEvent>(std::move(packetEvent));
-
-						m_incomingQueue.enqueue(producterToken, std::move(newEvent));
+						EnqueueIncomingPacket(peerId, std::move(event.packet->data), producterToken);
 						break;
 					}
 
@@ -210,73 +253,257 @@ namespace ewn
 		}
 	}
 
-	void NetworkReactor::SendPackets(const moodycamel::ProducerToken& producterToken, const moodycamel::ConsumerToken& token)
+	void NetworkReactor::SendPackets(const moodycamel::ProducerToken& producterToken, moodycamel::ConsumerToken& token)
 	{
-		OutgoingEvent outEvent;
-		while (m_outgoingQueue.try_dequeue(outEvent))
+		std::size_t eventCount;
+		while ((eventCount = m_outgoingQueue.try_dequeue_bulk(token, m_outgoingEvents.begin(), m_outgoingEvents.size())) > 0)
 		{
-			std::visit([&](auto&& arg) {
-				using T = std::decay_t<decltype(arg)>;
-				if constexpr (std::is_same_v<T, OutgoingEvent::DisconnectEvent>)
-				{
-					if (Nz::ENetPeer* peer = m_clients[outEvent.peerId])
+			for (std::size_t i = 0; i < eventCount; ++i)
+			{
+				OutgoingEvent& outEvent = m_outgoingEvents[i];
+
+				std::visit([&](auto&& arg) {
+					using T = std::decay_t<decltype(arg)>;
+					if constexpr (std::is_same_v<T, OutgoingEvent::DisconnectEvent>)
 					{
-						switch (arg.type)
+						if (Nz::ENetPeer* peer = m_clients[outEvent.peerId])
 						{
-							case DisconnectionType::Kick:
+							// Packets sent before the disconnection request have to go first
+							FlushPendingBatch(outEvent.peerId);
+
+							switch (arg.type)
 							{
-								peer->DisconnectNow(arg.data);
+								case DisconnectionType::Kick:
+								{
+									peer->DisconnectNow(arg.data);
 
-								// DisconnectNow does not generate Disconnect event
-								m_clients[outEvent.peerId] = nullptr;
+									// DisconnectNow does not generate Disconnect event
+									m_clients[outEvent.peerId] = nullptr;
 
-								IncomingEvent newEvent;
-								newEvent.peerId = m_firstId + outEvent.peerId;
+									IncomingEvent newEvent;
+									newEvent.peerId = m_firstId + outEvent.peerId;
 
-								auto& disconnectEvent = newEvent.data.emplace<IncomingEvent::DisconnectEvent>();
-								disconnectEvent.data = 0;
+									auto& disconnectEvent = newEvent.data.emplace<IncomingEvent::DisconnectEvent>();
+									disconnectEvent.data = 0;
 
-								m_incomingQueue.enqueue(producterToken, std::move(newEvent));
-								break;
-							}
+									m_incomingQueue.enqueue(producterToken, std::move(newEvent));
+									break;
+								}
 
-							case DisconnectionType::Later:
-								peer->DisconnectLater(arg.data);
-								break;
+								case DisconnectionType::Later:
+									peer->DisconnectLater(arg.data);
+									break;
 
-							case DisconnectionType::Normal:
-								peer->Disconnect(arg.data);
-								break;
+								case DisconnectionType::Normal:
+									peer->Disconnect(arg.data);
+									break;
 
-							default:
-								assert(!"Unknown disconnection type");
-								break;
+								default:
+									assert(!"Unknown disconnection type");
+									break;
+							}
 						}
 					}
-				}
-				else if constexpr (std::is_same_v<T, OutgoingEvent::PacketEvent>)
-				{
-					if (Nz::ENetPeer* peer = m_clients[outEvent.peerId])
-						peer->Send(arg.channelId, arg.flags, std::move(arg.packet));
-				}
-				else if constexpr (std::is_same_v<T, OutgoingEvent::QueryPeerInfo>)
-				{
-					if (Nz::ENetPeer* peer = m_clients[outEvent.peerId])
+					else if constexpr (std::is_same_v<T, OutgoingEvent::PacketEvent>)
 					{
-						IncomingEvent newEvent;
-						newEvent.peerId = m_firstId + outEvent.peerId;
+						if (m_clients[outEvent.peerId])
+						{
+							m_sentPacketTimes.push_back(arg.enqueueTime);
+							QueueOutgoingPacket(outEvent.peerId, arg.channelId, arg.flags, std::move(arg.packet));
+						}
+					}
+					else if constexpr (std::is_same_v<T, OutgoingEvent::SharedPacketEvent>)
+					{
+						if (m_clients[outEvent.peerId])
+						{
+							m_sentPacketTimes.push_back(arg.enqueueTime);
+							QueueOutgoingSharedPacket(outEvent.peerId, std::move(arg.packet));
+						}
+					}
+					else if constexpr (std::is_same_v<T, OutgoingEvent::QueryPeerInfo>)
+					{
+						if (Nz::ENetPeer* peer = m_clients[outEvent.peerId])
+						{
+							IncomingEvent newEvent;
+							newEvent.peerId = m_firstId + outEvent.peerId;
 
-						auto& peerInfo = newEvent.data.emplace<PeerInfo>();
-						peerInfo.lastReceiveTime = m_host.GetServiceTime() - peer->GetLastReceiveTime();
-						peerInfo.ping = peer->GetRoundTripTime();
+							auto& peerInfo = newEvent.data.emplace<PeerInfo>();
+							peerInfo.lastReceiveTime = m_host.GetServiceTime() - peer->GetLastReceiveTime();
+							peerInfo.ping = peer->GetRoundTripTime();
+							peerInfo.totalPacketLost = peer->GetTotalPacketLost();
+							peerInfo.totalPacketSent = peer->GetTotalPacketSent();
 
-						m_incomingQueue.enqueue(producterToken, std::move(newEvent));
+							m_incomingQueue.enqueue(producterToken, std::move(newEvent));
+						}
 					}
-				}
-				else
-					static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
+					else
+						static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
+
+				}, outEvent.data);
+			}
+		}
+
+		for (std::size_t peerId : m_batchingPeers)
+			FlushPendingBatch(peerId);
+
+		m_batchingPeers.clear();
+
+		m_cachedENetPacket = Nz::ENetPacketRef();
+		m_cachedSharedPacket = SharedPacket();
 
-			}, outEvent.data);
+		if (!m_sentPacketTimes.empty())
+		{
+			// Don't wait for the next service to put those packets on the wire
+			m_host.Flush();
+
+			Nz::UInt64 now = Nz::GetElapsedMicroseconds();
+			for (Nz::UInt64 enqueueTime : m_sentPacketTimes)
+				m_sendLatency.Record(now - enqueueTime);
+
+			m_sentPacketTimes.clear();
+		}
+	}
+
+	void NetworkReactor::EnqueueIncomingPacket(std::size_t peerId, Nz::NetPacket&& packet, const moodycamel::ProducerToken& producterToken)
+	{
+		auto EnqueuePacket = [&](Nz::NetPacket&& incomingPacket)
+		{
+			IncomingEvent newEvent;
+			newEvent.peerId = m_firstId + peerId;
+
+			auto& packetEvent = newEvent.data.emplace<IncomingEvent::PacketEvent>();
+			packetEvent.packet = std::move(incomingPacket);
+
+			m_incomingQueue.enqueue(producterToken, std::move(newEvent));
+		};
+
+		if (packet.GetDataSize() == 0 || packet.GetConstData()[Nz::NetPacket::HeaderSize] != BatchOpcode)
+		{
+			EnqueuePacket(std::move(packet));
+			return;
+		}
+
+		// Split coalesced packets, they will be handled as if they were received separately
+		try
+		{
+			Nz::UInt8 opcode;
+			packet >> opcode;
+
+			while (!packet.EndOfStream())
+			{
+				Nz::UInt16 packetSize;
+				packet >> packetSize;
+
+				m_batchBuffer.resize(packetSize);
+				if (packet.Read(m_batchBuffer.data(), packetSize) != packetSize)
+					throw std::runtime_error("Packet is truncated");
+
+				Nz::NetPacket batchedPacket;
+				batchedPacket.Reset(0, m_batchBuffer.data(), packetSize);
+
+				EnqueuePacket(std::move(batchedPacket));
+			}
+		}
+		catch (const std::exception&)
+		{
+			std::cerr << "Peer #" << m_firstId + peerId << " sent malformed batch packet" << std::endl;
+		}
+	}
+
+	void NetworkReactor::FlushPendingBatch(std::size_t peerId)
+	{
+		PendingBatch& pendingBatch = m_pendingBatches[peerId];
+		if (pendingBatch.packetCount == 0)
+			return;
+
+		if (Nz::ENetPeer* peer = m_clients[peerId])
+		{
+			if (pendingBatch.packetCount > 1)
+				peer->Send(pendingBatch.channelId, Nz::ENetPacketFlag_Reliable, std::move(pendingBatch.batch));
+			else
+				peer->Send(pendingBatch.channelId, Nz::ENetPacketFlag_Reliable, std::move(pendingBatch.firstPacket));
 		}
+
+		pendingBatch.packetCount = 0;
+	}
+
+	void NetworkReactor::QueueOutgoingPacket(std::size_t peerId, Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet)
+	{
+		// Coalesce small reliable packets into one ENet packet to save headers and acks, this doesn't change their ordering
+		constexpr std::size_t MaxBatchedPacketSize = 256;
+		constexpr std::size_t MaxBatchSize = 1200; //< Stay below the usual MTU to prevent fragmentation
+
+		Nz::ENetPeer* peer = m_clients[peerId];
+		PendingBatch& pendingBatch = m_pendingBatches[peerId];
+
+		std::size_t packetSize = packet.GetDataSize();
+		if (flags != Nz::ENetPacketFlag_Reliable || packetSize > MaxBatchedPacketSize)
+		{
+			if (pendingBatch.packetCount > 0 && pendingBatch.channelId == channelId)
+				FlushPendingBatch(peerId);
+
+			peer->Send(channelId, flags, std::move(packet));
+			return;
+		}
+
+		if (pendingBatch.packetCount > 0 && (pendingBatch.channelId != channelId || pendingBatch.batchSize + sizeof(Nz::UInt16) + packetSize > MaxBatchSize))
+			FlushPendingBatch(peerId);
+
+		auto AppendToBatch = [&](const Nz::NetPacket& batchedPacket)
+		{
+			std::size_t size = batchedPacket.GetDataSize();
+
+			pendingBatch.batch << static_cast<Nz::UInt16>(size);
+			pendingBatch.batch.Write(batchedPacket.GetConstData() + Nz::NetPacket::HeaderSize, size);
+			pendingBatch.batchSize += sizeof(Nz::UInt16) + size;
+		};
+
+		switch (pendingBatch.packetCount++)
+		{
+			case 0:
+				m_batchingPeers.push_back(peerId);
+
+				pendingBatch.channelId = channelId;
+				pendingBatch.firstPacket = std::move(packet);
+				pendingBatch.batchSize = sizeof(BatchOpcode) + sizeof(Nz::UInt16) + packetSize;
+				break;
+
+			case 1:
+				pendingBatch.batch = Nz::NetPacket();
+				pendingBatch.batch << BatchOpcode;
+				pendingBatch.batchSize = sizeof(BatchOpcode);
+
+				AppendToBatch(pendingBatch.firstPacket);
+				AppendToBatch(packet);
+				break;
+
+			default:
+				AppendToBatch(packet);
+				break;
+		}
+	}
+
+	void NetworkReactor::QueueOutgoingSharedPacket(std::size_t peerId, SharedPacket packet)
+	{
+		Nz::UInt8 channelId = packet.GetChannel();
+
+		PendingBatch& pendingBatch = m_pendingBatches[peerId];
+		if (pendingBatch.packetCount > 0 && pendingBatch.channelId == channelId)
+			FlushPendingBatch(peerId);
+
+		// Shared packets are usually sent to many peers in a row, copy them once into an ENet packet which all those peers will reference
+		// (ENet packets belong to the host and their refcount isn't atomic, so every reactor needs its own copy)
+		if (m_cachedSharedPacket != packet)
+		{
+			const Nz::NetPacket& sharedData = packet.GetPacket();
+
+			Nz::NetPacket packetCopy;
+			packetCopy.Reset(0, sharedData.GetConstData() + Nz::NetPacket::HeaderSize, sharedData.GetDataSize());
+
+			m_cachedENetPacket = m_host.AllocatePacket(packet.GetFlags(), std::move(packetCopy));
+			m_cachedSharedPacket = std::move(packet);
+		}
+
+		m_clients[peerId]->Send(channelId, m_cachedENetPacket);
 	}
 }
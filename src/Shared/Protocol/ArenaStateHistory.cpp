@@ -0,0 +1,150 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Shared" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Shared/Protocol/ArenaStateHistory.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace ewn
+{
+	bool ArenaStateHistory::DecodeState(Packets::ArenaState& state) const
+	{
+		if (state.baselineOffset == 0)
+		{
+			// Full state, every entity should have all its fields
+			return std::all_of(state.entities.begin(), state.entities.end(), [](const Packets::ArenaState::Entity& entity)
+			{
+				return entity.fields == EntityStateFieldFlags(EntityStateFieldFlags::ValueMask);
+			});
+		}
+
+		const Packets::ArenaState* baseline = GetState(static_cast<Nz::UInt16>(state.stateId - state.baselineOffset));
+		if (!baseline)
+			return false;
+
+		// Both entity lists are sorted by id
+		auto baselineIt = baseline->entities.begin();
+		for (auto& entity : state.entities)
+		{
+			if (entity.fields == EntityStateFieldFlags(EntityStateFieldFlags::ValueMask))
+				continue;
+
+			baselineIt = std::lower_bound(baselineIt, baseline->entities.end(), entity.id, [](const Packets::ArenaState::Entity& baselineEntity, Nz::UInt32 entityId)
+			{
+				return baselineEntity.id < entityId;
+			});
+
+			if (baselineIt == baseline->entities.end() || baselineIt->id != entity.id)
+				return false;
+
+			if (!(entity.fields & EntityStateField::AngularVelocity))
+				entity.angularVelocity = baselineIt->angularVelocity;
+
+			if (!(entity.fields & EntityStateField::LinearVelocity))
+				entity.linearVelocity = baselineIt->linearVelocity;
+
+			if (!(entity.fields & EntityStateField::Position))
+				entity.position = baselineIt->position;
+
+			if (!(entity.fields & EntityStateField::Rotation))
+				entity.rotation = baselineIt->rotation;
+
+			entity.fields = EntityStateFieldFlags::ValueMask;
+		}
+
+		state.baselineOffset = 0;
+		return true;
+	}
+
+	const Packets::ArenaState* ArenaStateHistory::GetState(Nz::UInt16 stateId) const
+	{
+		std::size_t index = stateId % MaxStateCount;
+		if (!m_validStates.test(index) || m_states[index].stateId != stateId)
+			return nullptr;
+
+		return &m_states[index];
+	}
+
+	void ArenaStateHistory::PushState(const Packets::ArenaState& state)
+	{
+		assert(state.baselineOffset == 0);
+		assert(std::is_sorted(state.entities.begin(), state.entities.end(), [](const Packets::ArenaState::Entity& lhs, const Packets::ArenaState::Entity& rhs) { return lhs.id < rhs.id; }));
+
+		std::size_t index = state.stateId % MaxStateCount;
+
+		// Reuse previous state memory, baselines only need entity states (not lifecycle records)
+		Packets::ArenaState& storedState = m_states[index];
+		storedState.baselineOffset = 0;
+		storedState.serverTime = state.serverTime;
+		storedState.stateId = state.stateId;
+		storedState.entities.assign(state.entities.begin(), state.entities.end());
+
+		m_validStates.set(index);
+	}
+
+	EntityStateFieldFlags ArenaStateHistory::ComputeChangedFields(const Packets::ArenaState::Entity& baseline, const Packets::ArenaState::Entity& entity)
+	{
+		EntityStateFieldFlags changedFields;
+		if (entity.angularVelocity != baseline.angularVelocity)
+			changedFields |= EntityStateField::AngularVelocity;
+
+		if (entity.linearVelocity != baseline.linearVelocity)
+			changedFields |= EntityStateField::LinearVelocity;
+
+		if (entity.position != baseline.position)
+			changedFields |= EntityStateField::Position;
+
+		if (entity.rotation != baseline.rotation)
+			changedFields |= EntityStateField::Rotation;
+
+		return changedFields;
+	}
+
+	std::size_t ArenaStateHistory::ComputeEntitySize(EntityStateFieldFlags fields)
+	{
+		// Id size is an estimation as it is compressed
+		std::size_t size = sizeof(Nz::UInt16) + sizeof(Nz::UInt8);
+		if (fields & EntityStateField::AngularVelocity)
+			size += Packets::ArenaState::AngularVelocityType::ByteCount;
+
+		if (fields & EntityStateField::LinearVelocity)
+			size += Packets::ArenaState::LinearVelocityType::ByteCount;
+
+		if (fields & EntityStateField::Position)
+			size += Packets::ArenaState::PositionType::ByteCount;
+
+		if (fields & EntityStateField::Rotation)
+			size += Packets::ArenaState::RotationType::ByteCount;
+
+		return size;
+	}
+
+	void ArenaStateHistory::EncodeDelta(const Packets::ArenaState& baseline, const Packets::ArenaState& state, Packets::ArenaState& delta)
+	{
+		assert(state.stateId != baseline.stateId);
+		assert(static_cast<Nz::UInt16>(state.stateId - baseline.stateId) < MaxStateCount);
+
+		delta.baselineOffset = static_cast<Nz::UInt8>(state.stateId - baseline.stateId);
+		delta.serverTime = state.serverTime;
+		delta.lastProcessedInputTime = state.lastProcessedInputTime;
+		delta.stateId = state.stateId;
+		delta.createdEntities.assign(state.createdEntities.begin(), state.createdEntities.end());
+		delta.deletedEntities.assign(state.deletedEntities.begin(), state.deletedEntities.end());
+		delta.entities.assign(state.entities.begin(), state.entities.end());
+
+		// Both entity lists are sorted by id
+		auto baselineIt = baseline.entities.begin();
+		for (auto& entity : delta.entities)
+		{
+			while (baselineIt != baseline.entities.end() && baselineIt->id < entity.id)
+				++baselineIt;
+
+			// Entities which are not part of the baseline are sent entirely
+			if (baselineIt == baseline.entities.end() || baselineIt->id != entity.id)
+				continue;
+
+			entity.fields = ComputeChangedFields(*baselineIt, entity);
+		}
+	}
+}
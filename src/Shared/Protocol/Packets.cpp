@@ -77,20 +77,61 @@ namespace ewn
 		void Serialize(PacketSerializer& serializer, ArenaState& data)
 		{
 			serializer &= data.stateId;
+			serializer &= data.baselineOffset;
 			serializer &= data.serverTime;
 			serializer &= data.lastProcessedInputTime;
 
+			serializer.SerializeArraySize(data.deletedEntities);
+			for (auto& entityData : data.deletedEntities)
+			{
+				serializer &= entityData.id;
+				serializer &= entityData.generation;
+			}
+
+			serializer.SerializeArraySize(data.createdEntities);
+			for (auto& entityData : data.createdEntities)
+			{
+				serializer &= entityData.angularVelocity;
+				serializer &= entityData.generation;
+				serializer &= entityData.id;
+				serializer &= entityData.linearVelocity;
+				serializer &= entityData.position;
+				serializer &= entityData.prefabId;
+				serializer &= entityData.rotation;
+
+				// Most entities (projectiles) are unnamed, don't spend a string header on them
+				bool hasName = !entityData.visualName.IsEmpty();
+				serializer &= hasName;
+
+				if (hasName)
+					serializer &= entityData.visualName;
+			}
+
 			serializer.SerializeArraySize(data.entities);
 			for (auto& entity : data.entities)
 			{
 				serializer &= entity.id;
-				serializer &= entity.position;
-				serializer &= entity.rotation;
-				serializer &= entity.angularVelocity;
-				serializer &= entity.linearVelocity;
+				serializer.Serialize<Nz::UInt8>(entity.fields);
+
+				if (entity.fields & EntityStateField::Position)
+					serializer.Serialize<ArenaState::PositionType>(entity.position);
+
+				if (entity.fields & EntityStateField::Rotation)
+					serializer.Serialize<ArenaState::RotationType>(entity.rotation);
+
+				if (entity.fields & EntityStateField::AngularVelocity)
+					serializer.Serialize<ArenaState::AngularVelocityType>(entity.angularVelocity);
+
+				if (entity.fields & EntityStateField::LinearVelocity)
+					serializer.Serialize<ArenaState::LinearVelocityType>(entity.linearVelocity);
 			}
 		}
 
+		void Serialize(PacketSerializer& serializer, ArenaStateAck& data)
+		{
+			serializer &= data.stateId;
+		}
+
 		void Serialize(PacketSerializer& serializer, BotMessage& data)
 		{
 			serializer.Serialize<Nz::UInt8>(data.messageType);
@@ -102,24 +143,15 @@ namespace ewn
 			serializer &= data.message;
 		}
 
-		void Serialize(PacketSerializer& serializer, ControlEntity& data)
+		void Serialize(PacketSerializer& serializer, ConnectionRedirect& data)
 		{
-			serializer &= data.id;
+			serializer &= data.port;
+			serializer &= data.token;
 		}
 
-		void Serialize(PacketSerializer& serializer, CreateEntities& data)
+		void Serialize(PacketSerializer& serializer, ControlEntity& data)
 		{
-			serializer.SerializeArraySize(data.entities);
-			for (auto& entityData : data.entities)
-			{
-				serializer &= entityData.angularVelocity;
-				serializer &= entityData.entityId;
-				serializer &= entityData.linearVelocity;
-				serializer &= entityData.position;
-				serializer &= entityData.prefabId;
-				serializer &= entityData.rotation;
-				serializer &= entityData.visualName;
-			}
+			serializer &= data.id;
 		}
 
 		void Serialize(PacketSerializer& serializer, CreateFleet& data)
@@ -169,13 +201,6 @@ namespace ewn
 		{
 		}
 
-		void Serialize(PacketSerializer& serializer, DeleteEntities& data)
-		{
-			serializer.SerializeArraySize(data.entities);
-			for (auto& id : data.entities)
-				serializer &= id;
-		}
-
 		void Serialize(PacketSerializer& serializer, DeleteFleet& data)
 		{
 			serializer &= data.fleetName;
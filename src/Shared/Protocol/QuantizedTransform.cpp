@@ -0,0 +1,75 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Shared" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Shared/Protocol/QuantizedTransform.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace ewn
+{
+	namespace
+	{
+		// The three smallest components of a unit quaternion are in [-1/sqrt(2), 1/sqrt(2)]
+		constexpr float ComponentMax = 0.707107f;
+		constexpr Nz::UInt32 ComponentBits = 10;
+		constexpr Nz::UInt32 ComponentMask = (1U << ComponentBits) - 1;
+		constexpr Nz::UInt32 ComponentSteps = ComponentMask - 1; //< even so zero is exactly represented
+	}
+
+	QuantizedQuaternion::QuantizedQuaternion(const Nz::Quaternionf& quaternion)
+	{
+		Nz::Quaternionf normalized = quaternion.GetNormal();
+		float components[4] = { normalized.w, normalized.x, normalized.y, normalized.z };
+
+		Nz::UInt32 largestIndex = 0;
+		for (Nz::UInt32 i = 1; i < 4; ++i)
+		{
+			if (std::abs(components[i]) > std::abs(components[largestIndex]))
+				largestIndex = i;
+		}
+
+		// q and -q represent the same rotation, make the largest component positive so we don't have to send its sign
+		float sign = (components[largestIndex] < 0.f) ? -1.f : 1.f;
+
+		m_bits = largestIndex << (3 * ComponentBits);
+
+		Nz::UInt32 shift = 2 * ComponentBits;
+		for (Nz::UInt32 i = 0; i < 4; ++i)
+		{
+			if (i == largestIndex)
+				continue;
+
+			float value = std::clamp(components[i] * sign, -ComponentMax, ComponentMax);
+			Nz::UInt32 integerValue = static_cast<Nz::UInt32>(std::lround((value + ComponentMax) / (2.f * ComponentMax) * ComponentSteps));
+
+			m_bits |= std::min(integerValue, ComponentSteps) << shift;
+			shift -= ComponentBits;
+		}
+	}
+
+	QuantizedQuaternion::operator Nz::Quaternionf() const
+	{
+		Nz::UInt32 largestIndex = m_bits >> (3 * ComponentBits);
+
+		float components[4];
+		float squaredSum = 0.f;
+
+		Nz::UInt32 shift = 2 * ComponentBits;
+		for (Nz::UInt32 i = 0; i < 4; ++i)
+		{
+			if (i == largestIndex)
+				continue;
+
+			Nz::UInt32 integerValue = std::min((m_bits >> shift) & ComponentMask, ComponentSteps);
+			components[i] = integerValue * (2.f * ComponentMax) / ComponentSteps - ComponentMax;
+			squaredSum += components[i] * components[i];
+
+			shift -= ComponentBits;
+		}
+
+		components[largestIndex] = std::sqrt(std::max(1.f - squaredSum, 0.f));
+
+		return Nz::Quaternionf(components[0], components[1], components[2], components[3]).GetNormal();
+	}
+}
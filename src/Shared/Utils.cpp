@@ -35,4 +35,19 @@ namespace ewn
 		// move the camera a bit towards the target
 		return currentPos + displacement;
 	}
+
+	std::size_t JumpConsistentHash(Nz::UInt64 key, std::size_t bucketCount)
+	{
+		// Jump consistent hash (Lamping & Veach), growing bucketCount only moves 1/bucketCount of the keys
+		Nz::Int64 bucket = -1;
+		Nz::Int64 nextBucket = 0;
+		while (nextBucket < Nz::Int64(bucketCount))
+		{
+			bucket = nextBucket;
+			key = key * 2862933555777941757ULL + 1;
+			nextBucket = Nz::Int64((bucket + 1) * (double(1LL << 31) / double((key >> 33) + 1)));
+		}
+
+		return std::size_t(bucket);
+	}
 }
@@ -0,0 +1,102 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Tests" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Nazara/Math/EulerAngles.hpp>
+#include <Shared/Protocol/QuantizedTransform.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// Checks don't rely on assert, so they also run in release builds
+
+namespace
+{
+	bool TestQuantizedQuaternion()
+	{
+		bool success = true;
+
+		// Rotations (identity included) must be restored within a fraction of a degree, q and -q being the same rotation
+		for (int pitch = -180; pitch <= 180; pitch += 45)
+		{
+			for (int yaw = -180; yaw <= 180; yaw += 30)
+			{
+				for (int roll = -180; roll <= 180; roll += 60)
+				{
+					Nz::Quaternionf rotation = Nz::EulerAnglesf(float(pitch), float(yaw), float(roll)).ToQuaternion();
+					ewn::QuantizedQuaternion quantized(rotation);
+
+					ewn::QuantizedQuaternion copy;
+					copy.SetBits(quantized.GetBits());
+
+					Nz::Quaternionf decoded = copy;
+					if (std::abs(rotation.DotProduct(decoded)) < 0.9999f)
+					{
+						std::cerr << "QuantizedQuaternion: " << rotation << " was decoded as " << decoded << std::endl;
+						success = false;
+					}
+				}
+			}
+		}
+
+		return success;
+	}
+
+	template<unsigned int MaxValue, unsigned int BitCount>
+	bool TestQuantizedVector3()
+	{
+		using Vector = ewn::QuantizedVector3<MaxValue, BitCount>;
+
+		// Float rounding of the scaled value may add up to half a step to the expected half step error
+		constexpr float Step = (2.f * MaxValue) / ((Nz::UInt64(1) << BitCount) - 2);
+
+		bool success = true;
+		auto CheckValue = [&](const Nz::Vector3f& expected, const Nz::Vector3f& decoded)
+		{
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				if (std::abs(decoded[i] - expected[i]) > Step)
+				{
+					std::cerr << "QuantizedVector3<" << MaxValue << ", " << BitCount << ">: " << expected << " was decoded as " << decoded << std::endl;
+					success = false;
+					break;
+				}
+			}
+		};
+
+		const float values[] = { -float(MaxValue), -MaxValue * 0.77f, -1.f, -Step / 3.f, 0.f, Step / 3.f, 0.5f, MaxValue * 0.33f, float(MaxValue) };
+		for (float x : values)
+		{
+			for (float y : values)
+			{
+				Nz::Vector3f vec(x, y, -x);
+				Vector quantized(vec);
+
+				Vector copy;
+				copy.SetBits(quantized.GetBits());
+
+				CheckValue(vec, copy);
+			}
+		}
+
+		// Out of range values are clamped
+		CheckValue(Nz::Vector3f(float(MaxValue), -float(MaxValue), 0.f), Vector(Nz::Vector3f(MaxValue * 2.f, -MaxValue * 2.f, 0.f)));
+
+		return success;
+	}
+}
+
+int main()
+{
+	bool success = true;
+	success = TestQuantizedQuaternion() && success;
+	success = TestQuantizedVector3<32, 16>() && success;     //< Packets::ArenaState::AngularVelocityType
+	success = TestQuantizedVector3<1024, 16>() && success;   //< Packets::ArenaState::LinearVelocityType
+	success = TestQuantizedVector3<16384, 21>() && success;  //< Packets::ArenaState::PositionType
+
+	if (!success)
+		return EXIT_FAILURE;
+
+	std::cout << "All tests passed" << std::endl;
+	return EXIT_SUCCESS;
+}